@@ -28,18 +28,20 @@ public:
         lastRes = -1.0f;
     }
 
-    void trigger(float velocity) override
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        phase = 0.0f;
-        env = velocity;
+        updateSmoothedValues();
+        
+        // Start fraction samples in: overshoot pitch, resonator phase, decay
+        const float elapsed = fraction / static_cast<float>(sampleRate);
+        phase = frequency(tune.getCurrentValue() + fineTune.getCurrentValue(), 0.0f) * elapsed;
+        env = velocity * std::exp(-elapsed / decayTime(decay.getCurrentValue()));
         active = true;
         
         // Trigger click
         clickPhase = 0.0f;
-        clickEnv = velocity * 0.3f;
-        pitchEnvTime = 0.0f;
-        
-        updateSmoothedValues();
+        clickEnv = velocity * 0.3f * std::pow(CLICK_DECAY, fraction);
+        pitchEnvTime = elapsed;
     }
 
     bool isActive() const override { return active && (env > 0.0001f || clickEnv > 0.0001f); }
@@ -61,17 +63,8 @@ public:
             float currentLevel = level.getNextValue();
             float currentTone = tone.getNextValue();
 
-            // TR-808 spec: Bridged-T resonator at 56 Hz with pitch overshoot
-            // Pitch envelope: brief overshoot then settle to 56 Hz over ~10ms
             pitchEnvTime += 1.0f / static_cast<float>(sampleRate);
-            float pitchMult = 1.0f;
-            if (pitchEnvTime < 0.01f) {
-                // Exponential drop from overshoot
-                pitchMult = 1.0f + (0.1f * std::exp(-pitchEnvTime / 0.003f));
-            }
-            
-            float baseFreq = 56.0f * std::pow(2.0f, currentTune / 12.0f);
-            float freq = (baseFreq * pitchMult) / static_cast<float>(sampleRate);
+            float freq = frequency(currentTune, pitchEnvTime) / static_cast<float>(sampleRate);
             
             // Generate sine wave (bridged-T resonator)
             float sample = std::sin(phase * juce::MathConstants<float>::twoPi) * env;
@@ -95,13 +88,10 @@ public:
                 sample += clickSample * 0.3f;
                 
                 // Fast click decay
-                clickEnv *= 0.95f;
+                clickEnv *= CLICK_DECAY;
             }
             
-            // Amplitude envelope: 100-1000ms range (default 500ms)
-            float decayTime = 0.1f + currentDecay * 0.9f;
-            float decayRate = std::exp(-1.0f / (decayTime * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate(currentDecay);
 
             // Apply optional post-filter using targetFilterCutoff/Res
             if (targetFilterCutoff > 0.0f)
@@ -123,6 +113,28 @@ public:
     }
 
 private:
+    // Fast click decay, per sample
+    static constexpr float CLICK_DECAY = 0.95f;
+    
+    // TR-808 spec: Bridged-T resonator at 56 Hz with pitch overshoot
+    // Pitch envelope: brief overshoot then settle to 56 Hz over ~10ms
+    static float frequency(float tuneSemitones, float time)
+    {
+        float pitchMult = 1.0f;
+        if (time < 0.01f) {
+            // Exponential drop from overshoot
+            pitchMult = 1.0f + (0.1f * std::exp(-time / 0.003f));
+        }
+        return 56.0f * std::pow(2.0f, tuneSemitones / 12.0f) * pitchMult;
+    }
+    
+    // Amplitude envelope: 100-1000ms range (default 500ms)
+    static float decayTime(float decaySetting) { return 0.1f + decaySetting * 0.9f; }
+    float decayRate(float decaySetting) const
+    {
+        return std::exp(-1.0f / (decayTime(decaySetting) * static_cast<float>(sampleRate)));
+    }
+    
     float phase = 0.0f;
     float env = 0.0f;
     bool active = false;
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "FastMath.h"
+#include <array>
+#include <cmath>
+
+/**
+ * The clipper transfer curves with their first and second antiderivatives, for
+ * antiderivative anti-aliasing (ADAA). Evaluated in double: the ADAA quotients
+ * divide differences of nearly equal antiderivative values.
+ *
+ *   Tanh: f = tanh(x)
+ *   Atan: f = (2/pi) atan(1.5x)
+ *   Poly: f = x - x^3/3 on |x| <= 1.5, held at +-0.375 beyond
+ */
+namespace ClipCurves
+{
+    enum Curve { Tanh = 0, Atan, Poly };
+
+    static constexpr double ATAN_SLOPE = 1.5;
+    static constexpr double POLY_LIMIT = 1.5;
+    static constexpr double LN2 = 0.69314718055994530942;
+
+    // Li2(-u) for 0 <= u <= 1; Landen's identity keeps the series argument <= 0.5
+    inline double dilogNegative(double u)
+    {
+        auto series = [](double z)
+        {
+            double sum = 0.0, power = z;
+            for (int k = 1; k < 64 && std::abs(power) > 1.0e-17 * k * k; ++k, power *= z)
+                sum += power / (k * k);
+            return sum;
+        };
+
+        if (u <= 0.5)
+            return series(-u);
+
+        const double log1p = std::log1p(u);
+        return -series(u / (1.0 + u)) - 0.5 * log1p * log1p;
+    }
+
+    inline double f(int curve, double x)
+    {
+        switch (curve)
+        {
+            case Atan: return (2.0 / juce::MathConstants<double>::pi) * std::atan(ATAN_SLOPE * x);
+            case Poly:
+            {
+                const double c = juce::jlimit(-POLY_LIMIT, POLY_LIMIT, x);
+                return c - c * c * c / 3.0;
+            }
+            default:   return std::tanh(x);
+        }
+    }
+
+    // First antiderivative (even, F1(0) = 0)
+    inline double F1(int curve, double x)
+    {
+        const double ax = std::abs(x);
+        switch (curve)
+        {
+            case Atan:
+            {
+                const double a = ATAN_SLOPE;
+                return (2.0 / juce::MathConstants<double>::pi)
+                     * (x * std::atan(a * x) - std::log1p(a * a * x * x) / (2.0 * a));
+            }
+            case Poly:
+            {
+                if (ax <= POLY_LIMIT)
+                    return 0.5 * x * x - x * x * x * x / 12.0;
+                const double edge = 0.5 * POLY_LIMIT * POLY_LIMIT - std::pow(POLY_LIMIT, 4.0) / 12.0;
+                return edge + f(Poly, POLY_LIMIT) * (ax - POLY_LIMIT);
+            }
+            default: // log(cosh x) without overflow
+                return ax + std::log1p(std::exp(-2.0 * ax)) - LN2;
+        }
+    }
+
+    // Second antiderivative (odd, F2(0) = 0)
+    inline double F2(int curve, double x)
+    {
+        const double ax = std::abs(x);
+        const double sign = x < 0.0 ? -1.0 : 1.0;
+        switch (curve)
+        {
+            case Atan:
+            {
+                const double a = ATAN_SLOPE;
+                const double at = std::atan(a * x);
+                return (2.0 / juce::MathConstants<double>::pi)
+                     * (0.5 * x * x * at + x / (2.0 * a) - at / (2.0 * a * a)
+                        - x * std::log1p(a * a * x * x) / (2.0 * a));
+            }
+            case Poly:
+            {
+                if (ax <= POLY_LIMIT)
+                    return x * x * x / 6.0 - x * x * x * x * x / 60.0;
+                const double over = ax - POLY_LIMIT;
+                const double edge = std::pow(POLY_LIMIT, 3.0) / 6.0 - std::pow(POLY_LIMIT, 5.0) / 60.0;
+                return sign * (edge + F1(Poly, POLY_LIMIT) * over + 0.5 * f(Poly, POLY_LIMIT) * over * over);
+            }
+            default:
+            {
+                // Integral of |t| - ln2 + log1p(e^-2|t|): the last term integrates to a dilogarithm
+                const double pi = juce::MathConstants<double>::pi;
+                return sign * (0.5 * ax * ax - LN2 * ax
+                               + 0.5 * (dilogNegative(std::exp(-2.0 * ax)) + pi * pi / 12.0));
+            }
+        }
+    }
+
+    // Float curves for the block kernels (FastMath, no branches)
+    template <int C> inline float shape(float x);
+    template <> inline float shape<Tanh>(float x) { return FastMath::tanh(x); }
+    template <> inline float shape<Atan>(float x) { return 0.636619772f * FastMath::atan(1.5f * x); }
+    template <> inline float shape<Poly>(float x)
+    {
+        const float c = std::min(1.5f, std::max(-1.5f, x));
+        return c - c * c * c * (1.0f / 3.0f);
+    }
+
+    // data = data + mix * (output * curve(drive * data) - data); the curve is fixed per
+    // instantiation so the loop body has no switch and vectorises
+    template <int C>
+    inline void processBlock(float* data, int numSamples, float drive, float output, float mix)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float dry = data[i];
+            data[i] = dry + mix * (output * shape<C>(drive * dry) - dry);
+        }
+    }
+
+    // One dispatch per block
+    inline void processBlock(int curve, float* data, int numSamples, float drive, float output, float mix = 1.0f)
+    {
+        switch (curve)
+        {
+            case Atan: processBlock<Atan>(data, numSamples, drive, output, mix); break;
+            case Poly: processBlock<Poly>(data, numSamples, drive, output, mix); break;
+            default:   processBlock<Tanh>(data, numSamples, drive, output, mix); break;
+        }
+    }
+}
+
+/**
+ * Stateful first/second-order ADAA waveshaper for up to two channels.
+ * First order delays by half a sample, second order by one sample (at the rate it runs at).
+ */
+class AdaaClipper
+{
+public:
+    enum Order { Off = 0, First, Second };
+
+    void setCurve(int newCurve)
+    {
+        if (newCurve != curve) { curve = newCurve; reset(); }
+    }
+
+    void setOrder(int newOrder)
+    {
+        if (newOrder != order) { order = newOrder; reset(); }
+    }
+
+    int getOrder() const { return order; }
+
+    // Whole-sample delay added at the processing rate
+    int getLatencySamples() const { return order == Second ? 1 : 0; }
+
+    float process(int channel, float input)
+    {
+        auto& s = state[static_cast<size_t>(channel)];
+        const double x = input;
+
+        if (order == First)
+        {
+            const double f1 = ClipCurves::F1(curve, x);
+            const double dx = x - s.x1;
+            const double y = std::abs(dx) > FIRST_ORDER_TOLERANCE ? (f1 - s.f1x1) / dx
+                                                                  : ClipCurves::f(curve, 0.5 * (x + s.x1));
+            s.x1 = x;
+            s.f1x1 = f1;
+            return static_cast<float>(y);
+        }
+
+        // Second order: divided difference of the first-order ADAA of F2
+        const double f2 = ClipCurves::F2(curve, x);
+        const double d1 = dividedDifference(x, s.x1, f2, s.f2x1);
+        const double dx2 = x - s.x2;
+
+        double y;
+        if (std::abs(dx2) > SECOND_ORDER_TOLERANCE)
+        {
+            y = 2.0 * (d1 - s.d1) / dx2;
+        }
+        else
+        {
+            // x[n] ~ x[n-2]: expand around their mean
+            const double mean = 0.5 * (x + s.x2);
+            const double delta = mean - s.x1;
+            y = std::abs(delta) > SECOND_ORDER_TOLERANCE
+                  ? 2.0 / delta * (ClipCurves::F1(curve, mean) + (s.f2x1 - ClipCurves::F2(curve, mean)) / delta)
+                  : ClipCurves::f(curve, 0.5 * (mean + s.x1));
+        }
+
+        s.x2 = s.x1;
+        s.x1 = x;
+        s.f2x1 = f2;
+        s.d1 = d1;
+        return static_cast<float>(y);
+    }
+
+    void reset() { state.fill({}); }
+
+private:
+    static constexpr double FIRST_ORDER_TOLERANCE = 1.0e-6;
+    static constexpr double SECOND_ORDER_TOLERANCE = 1.0e-4;
+
+    double dividedDifference(double a, double b, double f2a, double f2b) const
+    {
+        const double dx = a - b;
+        return std::abs(dx) > FIRST_ORDER_TOLERANCE ? (f2a - f2b) / dx : ClipCurves::F1(curve, 0.5 * (a + b));
+    }
+
+    struct ChannelState
+    {
+        double x1 = 0.0, x2 = 0.0; // previous inputs
+        double f1x1 = 0.0;         // F1(x1), first order
+        double f2x1 = 0.0, d1 = 0.0; // F2(x1) and the previous divided difference, second order
+    };
+
+    int curve = ClipCurves::Tanh, order = Off;
+    std::array<ChannelState, 2> state{};
+};
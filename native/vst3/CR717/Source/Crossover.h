@@ -0,0 +1,105 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "LaneBiquad.h"
+
+/**
+ * Stereo 3-band Linkwitz-Riley (LR4) crossover.
+ *
+ *   low  = LP4(f1)(x), then the f2 allpass
+ *   mid  = LP4(f2)(HP4(f1)(x))
+ *   high = HP4(f2)(HP4(f1)(x))
+ *
+ * LP4 + HP4 at one frequency is a second-order allpass, so passing the low band through
+ * that allpass makes the three bands sum to an allpass: flat magnitude, no notch at
+ * either crossover. Each split runs L and R through LP and HP as one 4-lane biquad
+ * (two Butterworth sections per LR4 filter).
+ */
+class ThreeBandCrossover
+{
+public:
+    enum Band { Low = 0, Mid, High, NUM_BANDS };
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        lowHz = highHz = 0.0f;
+        setFrequencies(150.0f, 4000.0f);
+        reset();
+    }
+
+    // Recomputes coefficients only when a frequency actually moves; f2 is kept above f1
+    void setFrequencies(float newLowHz, float newHighHz)
+    {
+        const float nyquistLimit = static_cast<float>(sampleRate * 0.45);
+        newLowHz = juce::jlimit(20.0f, nyquistLimit * 0.5f, newLowHz);
+        newHighHz = juce::jlimit(newLowHz * 1.5f, nyquistLimit, newHighHz);
+
+        if (std::abs(newLowHz - lowHz) > 0.5f)
+        {
+            lowHz = newLowHz;
+            setSplit(lowSplit, lowHz);
+        }
+
+        if (std::abs(newHighHz - highHz) > 0.5f)
+        {
+            highHz = newHighHz;
+            setSplit(highSplit, highHz);
+            lowAllpass.setCoefficients(juce::dsp::IIR::ArrayCoefficients<float>::makeAllPass(sampleRate, highHz));
+        }
+    }
+
+    // bands: low L, low R, mid L, mid R, high L, high R; each numSamples long
+    void process(const float* left, const float* right, const std::array<float*, 6>& bands, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // LP and HP of both channels at f1
+            LaneBiquad<4>::Lanes first{left[i], right[i], left[i], right[i]};
+            lowSplit[0].process(first);
+            lowSplit[1].process(first);
+
+            // The high-passed half splits again at f2
+            LaneBiquad<4>::Lanes second{first[2], first[3], first[2], first[3]};
+            highSplit[0].process(second);
+            highSplit[1].process(second);
+
+            LaneBiquad<2>::Lanes low{first[0], first[1]};
+            lowAllpass.process(low);
+
+            bands[0][i] = low[0];
+            bands[1][i] = low[1];
+            bands[2][i] = second[0];
+            bands[3][i] = second[1];
+            bands[4][i] = second[2];
+            bands[5][i] = second[3];
+        }
+    }
+
+    void reset()
+    {
+        for (auto& section : lowSplit) section.reset();
+        for (auto& section : highSplit) section.reset();
+        lowAllpass.reset();
+    }
+
+private:
+    // Lanes 0-1 low-pass, 2-3 high-pass, same frequency
+    void setSplit(std::array<LaneBiquad<4>, 2>& split, float frequency)
+    {
+        const auto lowPass = juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(sampleRate, frequency);
+        const auto highPass = juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(sampleRate, frequency);
+        for (auto& section : split)
+        {
+            section.setCoefficients(0, lowPass);
+            section.setCoefficients(1, lowPass);
+            section.setCoefficients(2, highPass);
+            section.setCoefficients(3, highPass);
+        }
+    }
+
+    double sampleRate = 44100.0;
+    float lowHz = 0.0f, highHz = 0.0f;
+    std::array<LaneBiquad<4>, 2> lowSplit, highSplit;
+    LaneBiquad<2> lowAllpass;
+};
@@ -27,7 +27,13 @@ public:
         }
     }
 
-    void trigger(float velocity) override { env = velocity; active = true; updateSmoothedValues(); }
+    // Oscillators run free; the decay starts fraction samples in
+    void trigger(float velocity, float fraction = 0.0f) override
+    {
+        updateSmoothedValues();
+        env = velocity * std::exp(-fraction / (decayTime(decay.getCurrentValue()) * static_cast<float>(sampleRate)));
+        active = true;
+    }
     bool isActive() const override { return active && env > 0.0001f; }
 
     void renderNextBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) override
@@ -54,16 +60,20 @@ public:
             
             float sample = filtered * env * level.getNextValue();
             
-            // Expo decay: 1.2s (TR-808 spec)
-            float decayTime = 1.2f * (0.5f + decay.getNextValue() * 0.5f);
-            float decayRate = std::exp(-1.0f / (decayTime * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate(decay.getNextValue());
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // Expo decay: 1.2s (TR-808 spec)
+    static float decayTime(float decaySetting) { return 1.2f * (0.5f + decaySetting * 0.5f); }
+    float decayRate(float decaySetting) const
+    {
+        return std::exp(-1.0f / (decayTime(decaySetting) * static_cast<float>(sampleRate)));
+    }
+
     float phases[6] = {0};
     float env = 0.0f;
     bool active = false;
@@ -91,7 +101,13 @@ public:
         }
     }
 
-    void trigger(float velocity) override { env = velocity; active = true; updateSmoothedValues(); }
+    // Oscillators run free; the decay starts fraction samples in
+    void trigger(float velocity, float fraction = 0.0f) override
+    {
+        env = velocity * std::exp(-fraction / (DECAY_TIME * static_cast<float>(sampleRate)));
+        active = true;
+        updateSmoothedValues();
+    }
     bool isActive() const override { return active && env > 0.0001f; }
 
     void renderNextBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) override
@@ -118,15 +134,17 @@ public:
             
             float sample = filtered * env * level.getNextValue();
             
-            // Expo decay: 1.9s (TR-808 spec, longer than cymbal)
-            float decayRate = std::exp(-1.0f / (1.9f * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate();
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // Expo decay: 1.9s (TR-808 spec, longer than cymbal)
+    static constexpr float DECAY_TIME = 1.9f;
+    float decayRate() const { return std::exp(-1.0f / (DECAY_TIME * static_cast<float>(sampleRate))); }
+
     float phases[6] = {0};
     float env = 0.0f;
     bool active = false;
@@ -145,7 +163,15 @@ public:
         filter.setCoefficients(juce::IIRCoefficients::makeBandPass(sr, 800.0));
     }
 
-    void trigger(float velocity) override { phase1 = 0.0f; phase2 = 0.0f; env = velocity; active = true; updateSmoothedValues(); }
+    void trigger(float velocity, float fraction = 0.0f) override
+    {
+        updateSmoothedValues();
+        const float tuneVal = tune.getCurrentValue();
+        phase1 = lowFrequency(tuneVal) / static_cast<float>(sampleRate) * fraction;
+        phase2 = highFrequency(tuneVal) / static_cast<float>(sampleRate) * fraction;
+        env = velocity * std::pow(DECAY, fraction);
+        active = true;
+    }
     bool isActive() const override { return active && env > 0.0001f; }
 
     void renderNextBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) override
@@ -156,8 +182,8 @@ public:
         {
             if (env <= 0.0001f) { active = false; break; }
             float tuneVal = tune.getNextValue();
-            float f1 = (540.0f + tuneVal * 50.0f) / static_cast<float>(sampleRate);
-            float f2 = (800.0f + tuneVal * 70.0f) / static_cast<float>(sampleRate);
+            float f1 = lowFrequency(tuneVal) / static_cast<float>(sampleRate);
+            float f2 = highFrequency(tuneVal) / static_cast<float>(sampleRate);
             
             float osc = std::sin(phase1 * juce::MathConstants<float>::twoPi) * 0.5f +
                        std::sin(phase2 * juce::MathConstants<float>::twoPi) * 0.5f;
@@ -165,12 +191,17 @@ public:
             phase2 += f2; if (phase2 >= 1.0f) phase2 -= 1.0f;
             
             float sample = filter.processSingleSampleRaw(osc) * env * level.getNextValue();
-            env *= 0.992f;
+            env *= DECAY;
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // Two sines at 540 and 800 Hz, decaying per sample
+    static float lowFrequency(float tuneVal) { return 540.0f + tuneVal * 50.0f; }
+    static float highFrequency(float tuneVal) { return 800.0f + tuneVal * 70.0f; }
+    static constexpr float DECAY = 0.992f;
+
     float phase1 = 0.0f, phase2 = 0.0f, env = 0.0f;
     bool active = false;
     juce::IIRFilter filter;
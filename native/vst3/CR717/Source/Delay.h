@@ -9,6 +9,7 @@ public:
     
     void prepare(double sampleRate, int maxBlockSize)
     {
+        juce::ignoreUnused(maxBlockSize);
         this->sampleRate = sampleRate;
         
         int maxDelaySamples = static_cast<int>(sampleRate * 2.0); // 2 seconds max
@@ -52,10 +53,14 @@ public:
     }
 
     void process(juce::AudioBuffer<float>& buffer)
+    {
+        process(buffer, buffer.getNumSamples());
+    }
+
+    void process(juce::AudioBuffer<float>& buffer, int numSamples)
     {
         auto* leftChannel = buffer.getWritePointer(0);
         auto* rightChannel = buffer.getWritePointer(1);
-        int numSamples = buffer.getNumSamples();
 
         for (int i = 0; i < numSamples; ++i)
         {
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+
+/**
+ * Event-driven sidechain ducker.
+ * The gain envelope is generated from trigger positions reported by the scheduler,
+ * so there is no detector and no lookahead: the duck starts on the exact sample the
+ * keying voice fires, ramps down over the attack time and recovers over the release.
+ */
+class TriggerDucker
+{
+public:
+    static constexpr int MAX_EVENTS = 64;
+
+    void prepare(double sr, int maxBlockSize)
+    {
+        sampleRate = sr;
+        gainCurve.assign(static_cast<size_t>(maxBlockSize), 1.0f);
+        reset();
+        updateCoefficients();
+    }
+
+    // Fallback for hosts that exceed the prepared block size
+    void ensureCapacity(int numSamples)
+    {
+        if (static_cast<int>(gainCurve.size()) < numSamples)
+            gainCurve.resize(static_cast<size_t>(numSamples), 1.0f);
+    }
+
+    void setDepth(float db) { depthGain = juce::Decibels::decibelsToGain(db); }
+
+    void setAttack(float ms)
+    {
+        if (ms != attackMs) { attackMs = ms; updateCoefficients(); }
+    }
+
+    void setRelease(float ms)
+    {
+        if (ms != releaseMs) { releaseMs = ms; updateCoefficients(); }
+    }
+
+    // Called by the scheduler; offsets may arrive out of order (sequencer vs MIDI)
+    void addTrigger(int sampleOffset, float velocity)
+    {
+        if (numEvents >= MAX_EVENTS)
+            return;
+
+        int pos = numEvents++;
+        while (pos > 0 && events[static_cast<size_t>(pos - 1)].offset > sampleOffset)
+        {
+            events[static_cast<size_t>(pos)] = events[static_cast<size_t>(pos - 1)];
+            --pos;
+        }
+        events[static_cast<size_t>(pos)] = {sampleOffset, velocity};
+    }
+
+    // Builds the per-sample gain curve for this block and consumes the queued triggers
+    void renderGain(int numSamples)
+    {
+        auto* gain = gainCurve.data();
+        const float range = depthGain - 1.0f;
+        int eventIndex = 0;
+        idle = (numEvents == 0 && duck == 0.0f && attackRemaining == 0);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            while (eventIndex < numEvents && events[static_cast<size_t>(eventIndex)].offset <= i)
+            {
+                const auto& e = events[static_cast<size_t>(eventIndex++)];
+                const float target = juce::jmax(duck, e.velocity);
+                attackRemaining = attackSamples;
+                attackStep = (target - duck) / static_cast<float>(attackSamples);
+            }
+
+            if (attackRemaining > 0)
+            {
+                duck += attackStep;
+                --attackRemaining;
+            }
+            else
+            {
+                duck *= releaseCoeff;
+                if (duck < 1.0e-5f)
+                    duck = 0.0f;
+            }
+
+            gain[i] = 1.0f + duck * range;
+        }
+
+        numEvents = 0;
+    }
+
+    // True when the last rendered block was fully at unity gain
+    bool isIdle() const { return idle; }
+
+    void apply(juce::AudioBuffer<float>& buffer, int numSamples) const
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::multiply(buffer.getWritePointer(ch), gainCurve.data(), numSamples);
+    }
+
+    const float* getGainCurve() const { return gainCurve.data(); }
+
+    void reset()
+    {
+        duck = 0.0f;
+        attackStep = 0.0f;
+        attackRemaining = 0;
+        numEvents = 0;
+        idle = true;
+    }
+
+private:
+    struct Event { int offset = 0; float velocity = 0.0f; };
+
+    void updateCoefficients()
+    {
+        attackSamples = juce::jmax(1, static_cast<int>(attackMs * 0.001 * sampleRate));
+        releaseCoeff = std::exp(-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
+    }
+
+    double sampleRate = 44100.0;
+    std::vector<float> gainCurve;
+    std::array<Event, MAX_EVENTS> events{};
+    int numEvents = 0;
+
+    float depthGain = 0.25f, attackMs = 2.0f, releaseMs = 150.0f;
+    int attackSamples = 1;
+    float releaseCoeff = 0.0f;
+
+    float duck = 0.0f, attackStep = 0.0f;
+    int attackRemaining = 0;
+    bool idle = true;
+};
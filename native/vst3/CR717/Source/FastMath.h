@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Branch-free float approximations for the per-sample hot paths (clip curves, dB
+ * conversions). Everything is plain arithmetic, min/max and selects, so loops over
+ * these auto-vectorise on both x86 and arm64. Error bounds are checked in
+ * tests/unit/dsp/test_fast_math.cpp.
+ */
+namespace FastMath
+{
+    inline float fromBits(std::uint32_t bits) { float f; std::memcpy(&f, &bits, sizeof f); return f; }
+    inline std::uint32_t toBits(float f) { std::uint32_t bits; std::memcpy(&bits, &f, sizeof f); return bits; }
+
+    // log2 for normal x > 0. Mantissa in [sqrt(1/2), sqrt(2)), atanh series in (m-1)/(m+1)
+    inline float log2(float x)
+    {
+        const std::uint32_t bits = toBits(x);
+        float exponent = static_cast<float>(static_cast<int>(bits >> 23) - 127);
+        float m = fromBits((bits & 0x007FFFFFu) | 0x3F800000u); // [1, 2)
+
+        const bool high = m > 1.41421356f;
+        m = high ? m * 0.5f : m;
+        exponent = high ? exponent + 1.0f : exponent;
+
+        const float t = (m - 1.0f) / (m + 1.0f);
+        const float t2 = t * t;
+        const float series = t * (2.88539008f + t2 * (0.961796694f + t2 * (0.577078016f + t2 * 0.412198583f)));
+        return exponent + series;
+    }
+
+    // 2^x, x clamped to the normal float range. Round-to-nearest split, degree-6 polynomial on [-1/2, 1/2]
+    inline float exp2(float x)
+    {
+        x = std::min(127.0f, std::max(-126.0f, x));
+        const int whole = static_cast<int>(x + (x < 0.0f ? -0.5f : 0.5f));
+        const float f = x - static_cast<float>(whole);
+
+        const float p = 1.0f + f * (0.693147181f + f * (0.240226507f + f * (0.0555041087f
+                             + f * (0.00961812911f + f * (0.00133335581f + f * 0.000154035304f)))));
+        return p * fromBits(static_cast<std::uint32_t>(whole + 127) << 23);
+    }
+
+    // Same clamp as juce::Decibels (-100 dB floor), input must be >= 0
+    inline float gainToDecibels(float gain)
+    {
+        return std::max(-100.0f, 6.02059991f * log2(std::max(gain, 1.0e-5f)));
+    }
+
+    inline float decibelsToGain(float db)
+    {
+        return db > -100.0f ? exp2(db * 0.166096405f) : 0.0f;
+    }
+
+    // [7/6] Pade approximant of tanh, output clamped to [-1, 1]
+    inline float tanh(float x)
+    {
+        x = std::min(5.0f, std::max(-5.0f, x)); // the approximant passes 1 just below 5
+        const float x2 = x * x;
+        const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+        return std::min(1.0f, std::max(-1.0f, num / den));
+    }
+
+    // atan with reduction to [0, 1] (atan x = pi/2 - atan 1/x) and an odd degree-17 polynomial
+    inline float atan(float x)
+    {
+        const float ax = std::abs(x);
+        const bool invert = ax > 1.0f;
+        const float t = invert ? 1.0f / ax : ax;
+        const float t2 = t * t;
+
+        float p = 0.0028662257f;
+        p = p * t2 - 0.0161657367f;
+        p = p * t2 + 0.0429096138f;
+        p = p * t2 - 0.0752896400f;
+        p = p * t2 + 0.1065626393f;
+        p = p * t2 - 0.1420889944f;
+        p = p * t2 + 0.1999355085f;
+        p = p * t2 - 0.3333314528f;
+        p = (p * t2 + 1.0f) * t;
+
+        const float r = invert ? 1.57079633f - p : p;
+        return x < 0.0f ? -r : r;
+    }
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "TripleBuffer.h"
+#include <array>
+#include <functional>
+
+/**
+ * Post-voice FX graph: a fixed set of stereo buses and processing nodes, driven by a
+ * precompiled list of ops (process node on bus, mix bus into bus, clear bus, delay the
+ * FX return to line up with a master bus that has been through latent stages).
+ *
+ * Routing changes are compiled into a Program on the message thread and published
+ * through a triple buffer, so the audio thread picks up the new order at the next
+ * block boundary without locks, allocation or ever seeing a half-written program.
+ */
+class FxGraph
+{
+public:
+    // Main is bound to the host buffer each block, the sends to the processor's send
+    // buffers; the remaining buses are owned (and preallocated) by the graph
+    enum Bus { Main = 0, SendA, SendB, FxReturn, NUM_BUSES };
+
+    enum Node
+    {
+        ReverbNode = 0, DelayNode, DuckReverbNode, DuckDelayNode,
+        CompressorNode, ClipperNode, LimiterNode,
+        ClipLimitNode, // clipper straight into limiter, may share one oversampled section
+        NUM_NODES
+    };
+
+    // Per-block gains referenced by mix ops (wet levels change without recompiling)
+    enum Gain { Unity = 0, ReverbWet, DelayWet, NUM_GAINS };
+
+    struct Op
+    {
+        enum Kind { Clear, Process, Mix, AlignReturn };
+        Kind kind = Clear;
+        int node = 0;   // Process
+        int source = 0; // Mix
+        int bus = 0;    // target of every op
+        int gain = Unity;
+    };
+
+    struct Program
+    {
+        static constexpr int MAX_OPS = 32;
+        std::array<Op, MAX_OPS> ops{};
+        int numOps = 0;
+        int routingKey = 0; // FxRouting::getKey() of the routing compiled, for whoever runs it
+
+        void clear(int bus)                         { add({Op::Clear, 0, 0, bus, Unity}); }
+        void process(int node, int bus)             { add({Op::Process, node, 0, bus, Unity}); }
+        void mix(int source, int bus, int gain)     { add({Op::Mix, 0, source, bus, gain}); }
+        void alignReturn()                          { add({Op::AlignReturn, 0, 0, FxReturn, Unity}); }
+
+    private:
+        void add(const Op& op)
+        {
+            jassert(numOps < MAX_OPS);
+            if (numOps < MAX_OPS)
+                ops[static_cast<size_t>(numOps++)] = op;
+        }
+    };
+
+    using NodeCallback = std::function<void(juce::AudioBuffer<float>&, int numSamples)>;
+
+    // Setup (not real-time): install the node callbacks once
+    void setNode(Node node, NodeCallback callback) { nodes[static_cast<size_t>(node)] = std::move(callback); }
+
+    // maxReturnDelay: the most the FX return will ever need delaying, in samples
+    void prepare(juce::AudioBuffer<float>& sendA, juce::AudioBuffer<float>& sendB, int maxBlockSize, int maxReturnDelay = 0)
+    {
+        buses[SendA] = &sendA;
+        buses[SendB] = &sendB;
+        buses[FxReturn] = &fxReturn;
+        fxReturn.setSize(2, maxBlockSize);
+        returnDelay.prepare({44100.0, static_cast<juce::uint32>(maxBlockSize), 2});
+        returnDelay.setMaximumDelayInSamples(juce::jmax(1, maxReturnDelay));
+        returnDelay.reset();
+    }
+
+    // Fallback for hosts that exceed the prepared block size
+    void ensureCapacity(int numSamples)
+    {
+        if (fxReturn.getNumSamples() < numSamples)
+            fxReturn.setSize(2, numSamples, false, false, true);
+    }
+
+    void setGain(Gain gain, float value) { gains[static_cast<size_t>(gain)] = value; }
+
+    // Audio thread: latency of the master stages an AlignReturn op's mix point comes after
+    void setReturnDelay(int samples)
+    {
+        returnDelay.setDelay(static_cast<float>(juce::jlimit(0, returnDelay.getMaximumDelayInSamples(), samples)));
+    }
+
+    // Message thread only (single writer)
+    void publish(const Program& program) { programs.publish(program); }
+
+    // Audio thread, before process(): takes the most recently published program, the one
+    // the block will run. Per-block settings that depend on the routing are worked out
+    // from it, not from what has been requested since
+    const Program& acquire()
+    {
+        current = &programs.acquire();
+        acquired = true;
+        return *current;
+    }
+    
+    // Audio thread: runs the program taken by acquire(), or the most recently published one
+    void process(juce::AudioBuffer<float>& mainBuffer, int numSamples)
+    {
+        if (!acquired)
+            acquire();
+        acquired = false;
+        buses[Main] = &mainBuffer;
+        const auto& program = *current;
+
+        for (int i = 0; i < program.numOps; ++i)
+        {
+            const auto& op = program.ops[static_cast<size_t>(i)];
+            auto& bus = *buses[static_cast<size_t>(op.bus)];
+
+            switch (op.kind)
+            {
+                case Op::Clear:
+                    for (int ch = 0; ch < 2; ++ch)
+                        bus.clear(ch, 0, numSamples);
+                    break;
+                case Op::Process:
+                    if (auto& node = nodes[static_cast<size_t>(op.node)])
+                        node(bus, numSamples);
+                    break;
+                case Op::Mix:
+                {
+                    const auto& source = *buses[static_cast<size_t>(op.source)];
+                    const float gain = gains[static_cast<size_t>(op.gain)];
+                    for (int ch = 0; ch < 2; ++ch)
+                        bus.addFrom(ch, 0, source, ch, 0, numSamples, gain);
+                    break;
+                }
+                case Op::AlignReturn:
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        auto* data = bus.getWritePointer(ch);
+                        for (int i = 0; i < numSamples; ++i)
+                        {
+                            returnDelay.pushSample(ch, data[i]);
+                            data[i] = returnDelay.popSample(ch);
+                        }
+                    }
+                    break;
+            }
+        }
+    }
+
+private:
+    std::array<NodeCallback, NUM_NODES> nodes;
+    std::array<juce::AudioBuffer<float>*, NUM_BUSES> buses{};
+    juce::AudioBuffer<float> fxReturn;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> returnDelay{1};
+    std::array<float, NUM_GAINS> gains{1.0f, 1.0f, 1.0f};
+
+    TripleBuffer<Program> programs;
+    const Program* current = nullptr;
+    bool acquired = false;
+};
+
+/**
+ * The user-facing routing choices, compiled to an FxGraph::Program.
+ */
+struct FxRouting
+{
+    enum SendChain { Parallel = 0, ReverbIntoDelay, DelayIntoReverb };
+    enum MasterOrder { CompClipLimit = 0, ClipCompLimit };
+    enum ReturnPoint { PreDynamics = 0, PostCompressor };
+
+    int sendChain = Parallel;
+    int masterOrder = CompClipLimit;
+    int returnPoint = PreDynamics;
+
+    int getKey() const { return sendChain | (masterOrder << 4) | (returnPoint << 8); }
+    
+    static FxRouting fromKey(int key)
+    {
+        FxRouting routing;
+        routing.sendChain = key & 15;
+        routing.masterOrder = (key >> 4) & 15;
+        routing.returnPoint = (key >> 8) & 15;
+        return routing;
+    }
+    
+    bool clipperFeedsLimiter() const { return masterOrder == CompClipLimit; }
+
+    FxGraph::Program compile() const
+    {
+        FxGraph::Program p;
+        p.routingKey = getKey();
+
+        // Send FX, ducked on their returns; a chained effect feeds the other's input
+        if (sendChain == DelayIntoReverb)
+        {
+            p.process(FxGraph::DelayNode, FxGraph::SendB);
+            p.process(FxGraph::DuckDelayNode, FxGraph::SendB);
+            p.mix(FxGraph::SendB, FxGraph::SendA, FxGraph::DelayWet);
+            p.process(FxGraph::ReverbNode, FxGraph::SendA);
+            p.process(FxGraph::DuckReverbNode, FxGraph::SendA);
+        }
+        else
+        {
+            p.process(FxGraph::ReverbNode, FxGraph::SendA);
+            p.process(FxGraph::DuckReverbNode, FxGraph::SendA);
+            if (sendChain == ReverbIntoDelay)
+                p.mix(FxGraph::SendA, FxGraph::SendB, FxGraph::ReverbWet);
+            p.process(FxGraph::DelayNode, FxGraph::SendB);
+            p.process(FxGraph::DuckDelayNode, FxGraph::SendB);
+        }
+
+        // Returns go straight into the master, or are held back on the return bus and
+        // delayed by the latency of the master stages they skip
+        const int returnBus = returnPoint == PostCompressor ? FxGraph::FxReturn : FxGraph::Main;
+        if (returnBus != FxGraph::Main)
+            p.clear(returnBus);
+        p.mix(FxGraph::SendA, returnBus, FxGraph::ReverbWet);
+        p.mix(FxGraph::SendB, returnBus, FxGraph::DelayWet);
+        if (returnBus != FxGraph::Main)
+            p.alignReturn();
+
+        // Master dynamics
+        if (masterOrder == ClipCompLimit)
+        {
+            p.process(FxGraph::ClipperNode, FxGraph::Main);
+            p.process(FxGraph::CompressorNode, FxGraph::Main);
+            if (returnBus != FxGraph::Main)
+                p.mix(FxGraph::FxReturn, FxGraph::Main, FxGraph::Unity);
+            p.process(FxGraph::LimiterNode, FxGraph::Main);
+        }
+        else
+        {
+            p.process(FxGraph::CompressorNode, FxGraph::Main);
+            if (returnBus != FxGraph::Main)
+                p.mix(FxGraph::FxReturn, FxGraph::Main, FxGraph::Unity);
+            p.process(FxGraph::ClipLimitNode, FxGraph::Main);
+        }
+
+        return p;
+    }
+};
@@ -32,9 +32,10 @@ public:
         lastRes = -1.0f;
     }
 
-    void trigger(float velocity) override
+    // Oscillators run free; the decay starts fraction samples in
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        env = velocity;
+        env = velocity * std::exp(-fraction / (DECAY_TIME * static_cast<float>(sampleRate)));
         active = true;
         updateSmoothedValues();
     }
@@ -87,15 +88,17 @@ public:
                 sample = postFilter.processSample(0, sample);
             }
             
-            // Expo decay: 190ms
-            float decayRate = std::exp(-1.0f / (0.19f * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate();
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // Expo decay: 190ms
+    static constexpr float DECAY_TIME = 0.19f;
+    float decayRate() const { return std::exp(-1.0f / (DECAY_TIME * static_cast<float>(sampleRate))); }
+
     float phases[6] = {0};
     float env = 0.0f;
     bool active = false;
@@ -134,11 +137,12 @@ public:
         lastRes = -1.0f;
     }
 
-    void trigger(float velocity) override
+    // Oscillators run free; the decay starts fraction samples in
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        env = velocity;
-        active = true;
         updateSmoothedValues();
+        env = velocity * std::exp(-fraction / (decayTime(decay.getCurrentValue()) * static_cast<float>(sampleRate)));
+        active = true;
     }
     
     void stop() override
@@ -191,16 +195,20 @@ public:
                 sample = postFilter.processSample(0, sample);
             }
             
-            // Expo decay: 490ms (longer than CH)
-            float baseDecayTime = 0.49f * (0.5f + currentDecay * 0.5f);
-            float decayRate = std::exp(-1.0f / (baseDecayTime * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate(currentDecay);
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // Expo decay: 490ms (longer than CH)
+    static float decayTime(float decaySetting) { return 0.49f * (0.5f + decaySetting * 0.5f); }
+    float decayRate(float decaySetting) const
+    {
+        return std::exp(-1.0f / (decayTime(decaySetting) * static_cast<float>(sampleRate)));
+    }
+
     float phases[6] = {0};
     float env = 0.0f;
     bool active = false;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+/**
+ * N biquads (transposed direct form II) stepped together, one per lane, each with its
+ * own coefficients. Every step is the same arithmetic on all lanes, so for N = 2 or 4
+ * the inner loops compile to one SIMD register op each.
+ */
+template <size_t N>
+class LaneBiquad
+{
+public:
+    using Lanes = std::array<float, N>;
+
+    // b0, b1, b2, a0, a1, a2 as returned by juce::dsp::IIR::ArrayCoefficients
+    void setCoefficients(size_t lane, const std::array<float, 6>& c)
+    {
+        const float a0 = c[3];
+        b0[lane] = c[0] / a0; b1[lane] = c[1] / a0; b2[lane] = c[2] / a0;
+        a1[lane] = c[4] / a0; a2[lane] = c[5] / a0;
+    }
+
+    void setCoefficients(const std::array<float, 6>& c)
+    {
+        for (size_t k = 0; k < N; ++k)
+            setCoefficients(k, c);
+    }
+
+    // One sample per lane, in place
+    void process(Lanes& x)
+    {
+        for (size_t k = 0; k < N; ++k)
+        {
+            const float y = b0[k] * x[k] + s1[k];
+            s1[k] = b1[k] * x[k] - a1[k] * y + s2[k];
+            s2[k] = b2[k] * x[k] - a2[k] * y;
+            x[k] = y;
+        }
+    }
+
+    void reset() { s1 = {}; s2 = {}; }
+
+private:
+    Lanes b0 = filled(1.0f), b1{}, b2{}, a1{}, a2{};
+    Lanes s1{}, s2{};
+
+    static Lanes filled(float value)
+    {
+        Lanes lanes;
+        lanes.fill(value);
+        return lanes;
+    }
+};
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "FastMath.h"
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Inter-sample peak estimate for running the limiter at the host rate: a 4-phase,
+ * 12-tap windowed-sinc interpolator (as in ITU-R BS.1770) on the detector path only. Reports the largest
+ * magnitude over the interval around x[n - DELAY], across channels.
+ */
+class TruePeakDetector
+{
+public:
+    static constexpr int PHASES = 4, TAPS = 12, DELAY = TAPS / 2;
+    using Coefficients = std::array<std::array<float, TAPS>, PHASES>;
+
+    TruePeakDetector()
+        : coeffs(makeCoefficients())
+    {
+        reset();
+    }
+
+    // coeffs[p][j] weights x[n - j] for the point n - DELAY + p / PHASES
+    static Coefficients makeCoefficients()
+    {
+        Coefficients c{};
+        const double pi = juce::MathConstants<double>::pi;
+        for (int p = 0; p < PHASES; ++p)
+        {
+            double sum = 0.0;
+            for (int j = 0; j < TAPS; ++j)
+            {
+                // Distance from x[n - j] to the evaluation point n - DELAY + p / PHASES
+                const double d = j - DELAY + static_cast<double>(p) / PHASES;
+                const double sinc = std::abs(d) < 1.0e-9 ? 1.0 : std::sin(pi * d) / (pi * d);
+                const double window = 0.5 + 0.5 * std::cos(pi * d / (DELAY + 0.5));
+                c[static_cast<size_t>(p)][static_cast<size_t>(j)] = static_cast<float>(sinc * window);
+                sum += sinc * window;
+            }
+            for (auto& tap : c[static_cast<size_t>(p)])
+                tap = static_cast<float>(tap / sum);
+        }
+        return c;
+    }
+
+    // Push one sample per channel, return the peak of the current and previous interval
+    // (a sample's gain has to cover the reconstruction on both sides of it)
+    float process(const float* const* channels, int numChannels, int index)
+    {
+        float peak = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& h = history[static_cast<size_t>(ch)];
+            pos[static_cast<size_t>(ch)] = (pos[static_cast<size_t>(ch)] + TAPS - 1) % TAPS;
+            const int start = pos[static_cast<size_t>(ch)];
+            h[static_cast<size_t>(start)] = h[static_cast<size_t>(start + TAPS)] = channels[ch][index];
+
+            for (const auto& phase : coeffs)
+            {
+                float y = 0.0f;
+                for (int j = 0; j < TAPS; ++j)
+                    y += phase[static_cast<size_t>(j)] * h[static_cast<size_t>(start + j)];
+                peak = std::max(peak, std::abs(y));
+            }
+        }
+
+        const float result = std::max(peak, previousPeak);
+        previousPeak = peak;
+        return result;
+    }
+
+    void reset()
+    {
+        for (auto& h : history) h.fill(0.0f);
+        pos.fill(0);
+        previousPeak = 0.0f;
+    }
+
+private:
+    Coefficients coeffs{};
+    std::array<std::array<float, 2 * TAPS>, 2> history{}; // newest first, mirrored so reads never wrap
+    std::array<int, 2> pos{};
+    float previousPeak = 0.0f;
+};
+
+/**
+ * Lookahead brickwall limiter, O(1) amortised per sample:
+ *
+ *   target gain -> sliding minimum over the window (monotonic deque)
+ *               -> release (instant down, one-pole up)
+ *               -> moving average over the same window (the attack ramp)
+ *
+ * Every gain sample that reaches the output is an average of window minima that all
+ * include the target of the (delayed) sample it is applied to, so the output can never
+ * exceed the ceiling. Audio is delayed by the lookahead (plus the detector delay).
+ */
+class LookaheadLimiter
+{
+public:
+    static constexpr int MAX_CHANNELS = 2;
+
+    // Not real-time: size every buffer for the longest lookahead, in samples at the processing rate
+    void prepare(int maxLookaheadSamples)
+    {
+        const size_t capacity = static_cast<size_t>(maxLookaheadSamples + 1);
+        minIndex.assign(capacity, 0);
+        minValue.assign(capacity, 1.0f);
+        averageRing.assign(capacity, 1.0f);
+        targetRing.assign(capacity, 1.0f);
+        for (auto& d : delayRing)
+            d.assign(capacity + TruePeakDetector::DELAY, 0.0f);
+        maxLookahead = maxLookaheadSamples;
+        lookahead = juce::jmin(lookahead, maxLookahead);
+        reset();
+    }
+
+    // Resets the state when the window or detector changes (the latency changes with it)
+    void setLookahead(int samples, bool interSampleDetection)
+    {
+        samples = juce::jlimit(0, maxLookahead, samples);
+        if (samples != lookahead || interSampleDetection != useDetector)
+        {
+            lookahead = samples;
+            useDetector = interSampleDetection;
+            reset();
+        }
+    }
+
+    int getLatencySamples() const { return lookahead + (useDetector ? TruePeakDetector::DELAY : 0); }
+
+    void setParameters(float newCeilingGain, float newKneeDb, float newReleaseCoeff)
+    {
+        ceilingGain = newCeilingGain;
+        kneeDb = newKneeDb;
+        releaseCoeff = newReleaseCoeff;
+    }
+
+    // Gain computer: a knee of kneeDb centred on the ceiling, whose top lands exactly
+    // on the ceiling, so the output never exceeds it
+    static float targetGain(float peak, float ceilingGain, float kneeDb)
+    {
+        const float kneeStartGain = kneeDb > 0.01f ? ceilingGain * FastMath::decibelsToGain(-0.5f * kneeDb) : ceilingGain;
+        if (peak <= kneeStartGain)
+            return 1.0f;
+
+        const float ceilingDb = FastMath::gainToDecibels(ceilingGain);
+        const float peakDb = FastMath::gainToDecibels(peak);
+        if (kneeDb <= 0.01f || peakDb >= ceilingDb + 0.5f * kneeDb)
+            return ceilingGain / peak;
+
+        const float over = peakDb - ceilingDb + 0.5f * kneeDb;
+        return FastMath::decibelsToGain(-over * over / (2.0f * kneeDb));
+    }
+
+    void process(float* const* channels, int numChannels, int numSamples)
+    {
+        jassert(numChannels <= MAX_CHANNELS);
+        const int window = lookahead + 1;
+        const int capacity = static_cast<int>(minIndex.size());
+        const int delayCapacity = static_cast<int>(delayRing[0].size());
+        const int delay = getLatencySamples();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float peak = 0.0f;
+            if (useDetector)
+            {
+                peak = detector.process(channels, numChannels, i);
+            }
+            else
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    peak = std::max(peak, std::abs(channels[ch][i]));
+            }
+
+            const float target = juce::jmin(targetGain(peak, ceilingGain, kneeDb), 1.0f);
+
+            // Sliding minimum: drop the expired value from the front before pushing, so the
+            // deque never holds more than the window; larger values leave from the back
+            if (minCount > 0 && counter - minIndex[static_cast<size_t>(minHead)] >= static_cast<std::uint32_t>(window))
+            {
+                minHead = (minHead + 1) % capacity;
+                --minCount;
+            }
+            while (minCount > 0 && minValue[static_cast<size_t>(back())] >= target)
+                --minCount;
+            minIndex[static_cast<size_t>((minHead + minCount) % capacity)] = counter;
+            minValue[static_cast<size_t>((minHead + minCount) % capacity)] = target;
+            ++minCount;
+            const float held = minValue[static_cast<size_t>(minHead)];
+
+            // Release
+            released = held < released ? held : held + releaseCoeff * (released - held);
+
+            // Attack ramp: moving average of the released minimum over the window
+            const size_t slot = static_cast<size_t>(ringPos);
+            average += static_cast<double>(released) - averageRing[slot];
+            averageRing[slot] = released;
+
+            // The oldest target kept belongs to the sample leaving the delay line; clamping
+            // to it only guards against rounding in the running average
+            targetRing[slot] = target;
+            ringPos = (ringPos + 1) % window;
+            const float oldestTarget = targetRing[static_cast<size_t>(ringPos)];
+
+            gain = juce::jmin(static_cast<float>(average / window), oldestTarget);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto& d = delayRing[static_cast<size_t>(ch)];
+                d[static_cast<size_t>(delayPos)] = channels[ch][i];
+                const int readPos = (delayPos - delay + delayCapacity) % delayCapacity;
+                channels[ch][i] = d[static_cast<size_t>(readPos)] * gain;
+            }
+            delayPos = (delayPos + 1) % delayCapacity;
+            ++counter;
+        }
+    }
+
+    float getGain() const { return gain; }
+
+    // Minimum target over the current window, before release and the attack ramp
+    float getHeldGain() const { return minCount > 0 ? minValue[static_cast<size_t>(minHead)] : 1.0f; }
+
+    void reset()
+    {
+        std::fill(averageRing.begin(), averageRing.end(), 1.0f);
+        std::fill(targetRing.begin(), targetRing.end(), 1.0f);
+        for (auto& d : delayRing)
+            std::fill(d.begin(), d.end(), 0.0f);
+        detector.reset();
+        minHead = minCount = 0;
+        counter = 0;
+        average = lookahead + 1;
+        released = gain = 1.0f;
+        ringPos = delayPos = 0;
+    }
+
+private:
+    int back() const { return (minHead + minCount - 1) % static_cast<int>(minIndex.size()); }
+
+    TruePeakDetector detector;
+    bool useDetector = false;
+    int lookahead = 0, maxLookahead = 0;
+    float ceilingGain = 1.0f, kneeDb = 0.0f, releaseCoeff = 0.0f;
+
+    std::vector<std::uint32_t> minIndex; // monotonic deque (ring): increasing values, oldest first
+    std::vector<float> minValue;
+    int minHead = 0, minCount = 0;
+    std::uint32_t counter = 0;
+
+    std::vector<float> averageRing, targetRing;
+    double average = 1.0;
+    int ringPos = 0;
+    float released = 1.0f, gain = 1.0f;
+
+    std::array<std::vector<float>, MAX_CHANNELS> delayRing;
+    int delayPos = 0;
+};
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "LaneBiquad.h"
+#include "LookaheadLimiter.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Output meter for the audio thread: EBU R128 / ITU-R BS.1770-4 loudness plus sample
+ * peak, RMS and 4x true peak.
+ *
+ *   K-weighting (shelf + RLB high-pass) -> mean square per 100 ms step
+ *   momentary  = last 4 steps (400 ms), short-term = last 30 steps (3 s)
+ *   integrated = gated mean of the 400 ms blocks (absolute -70 LUFS, relative -10 LU)
+ *   LRA        = 95th - 10th percentile of short-term values (gates -70 LUFS, -20 LU)
+ *
+ * Gated blocks go into 0.1 LU histograms (count and energy per bin), so integrated
+ * loudness and LRA cost the same after an hour as after a second and never allocate.
+ *
+ * Every 20 ms a Frame goes to a lock-free SPSC queue for the editor. When the queue is
+ * full the frame keeps accumulating and goes out with the next one, so a peak is only
+ * ever reported late, never dropped.
+ */
+class LoudnessMeter
+{
+public:
+    static constexpr float SILENCE = -100.0f; // LUFS / dBTP reported before there is anything to measure
+
+    struct Frame
+    {
+        std::array<float, 2> peak{};     // sample peak, linear
+        std::array<float, 2> rms{};      // unweighted RMS, linear
+        std::array<float, 2> truePeak{}; // 4x oversampled peak, linear
+        float momentary = SILENCE, shortTerm = SILENCE, integrated = SILENCE; // LUFS
+        float range = 0.0f;              // LRA, LU
+        float maxTruePeak = SILENCE;     // dBTP since the last reset
+    };
+
+    // Not real-time
+    void prepare(double sampleRate, int maxBlockSize)
+    {
+        frameLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.02));
+        stepLength = FRAMES_PER_STEP * frameLength;
+        maxChunk = juce::jmax(1, maxBlockSize);
+        setKWeighting(sampleRate);
+
+        for (auto& buffer : weighted)
+            buffer.assign(static_cast<size_t>(maxChunk), 0.0f);
+        for (auto& buffer : truePeakInput)
+            buffer.assign(static_cast<size_t>(maxChunk + HISTORY), 0.0f);
+        interpolated.assign(static_cast<size_t>(maxChunk), 0.0f);
+        reset();
+    }
+
+    // Starts a new measurement: integrated loudness, LRA and max true peak included
+    void reset()
+    {
+        shelf.reset();
+        highPass.reset();
+        for (auto& buffer : truePeakInput)
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+        frameSamples = 0;
+        stepFrames = 0;
+        stepSum = {};
+        stepEnergies.fill(0.0);
+        stepIndex = 0;
+        stepsMeasured = 0;
+        blocks.clear();
+        shortTermValues.clear();
+        clearPending();
+
+        momentary = shortTerm = integrated = SILENCE;
+        range = 0.0f;
+        maxTruePeakDb = SILENCE;
+    }
+
+    // Audio thread. Any block size; frames and steps are cut at exact sample positions
+    void process(const float* left, const float* right, int numSamples)
+    {
+        int offset = 0;
+        while (offset < numSamples)
+        {
+            const int n = juce::jmin(numSamples - offset, maxChunk, frameLength - frameSamples);
+            measureChunk(left + offset, right + offset, n);
+            offset += n;
+            frameSamples += n;
+            if (frameSamples == frameLength)
+                endFrame();
+        }
+    }
+
+    // Editor thread: the oldest unread frame, false when there is none
+    bool popFrame(Frame& frame) { return frames.pop(frame); }
+
+    float getMomentary() const { return momentary; }
+    float getShortTerm() const { return shortTerm; }
+    float getIntegrated() const { return integrated; }
+    float getLoudnessRange() const { return range; }
+    float getMaxTruePeak() const { return maxTruePeakDb; }
+
+private:
+    static constexpr int FRAMES_PER_STEP = 5, MOMENTARY_STEPS = 4, SHORT_TERM_STEPS = 30;
+    static constexpr int HISTORY = TruePeakDetector::TAPS - 1;
+    static constexpr double ABSOLUTE_GATE = -70.0;
+
+    static double toLufs(double energy)
+    {
+        return energy > 0.0 ? std::max(static_cast<double>(SILENCE), -0.691 + 10.0 * std::log10(energy))
+                            : static_cast<double>(SILENCE);
+    }
+
+    // 0.1 LU bins from -70 to +10 LUFS with count and energy per bin; values under the absolute gate are dropped
+    struct Histogram
+    {
+        static constexpr int NUM_BINS = 800;
+
+        void clear()
+        {
+            counts.fill(0);
+            energies.fill(0.0);
+        }
+
+        void add(double energy)
+        {
+            const double lufs = toLufs(energy);
+            if (lufs <= ABSOLUTE_GATE)
+                return;
+            const int bin = juce::jlimit(0, NUM_BINS - 1, static_cast<int>((lufs - ABSOLUTE_GATE) * 10.0));
+            ++counts[static_cast<size_t>(bin)];
+            energies[static_cast<size_t>(bin)] += energy;
+        }
+
+        // First bin whose centre is at or above the gate
+        static int firstBinAbove(double gateLufs)
+        {
+            return juce::jlimit(0, NUM_BINS, static_cast<int>(std::ceil((gateLufs - ABSOLUTE_GATE) * 10.0 - 0.5)));
+        }
+
+        static double binCentre(int bin) { return ABSOLUTE_GATE + (bin + 0.5) * 0.1; }
+
+        uint64_t count(int firstBin) const
+        {
+            uint64_t n = 0;
+            for (int b = firstBin; b < NUM_BINS; ++b)
+                n += counts[static_cast<size_t>(b)];
+            return n;
+        }
+
+        double meanEnergy(int firstBin) const
+        {
+            uint64_t n = 0;
+            double sum = 0.0;
+            for (int b = firstBin; b < NUM_BINS; ++b)
+            {
+                n += counts[static_cast<size_t>(b)];
+                sum += energies[static_cast<size_t>(b)];
+            }
+            return n > 0 ? sum / static_cast<double>(n) : 0.0;
+        }
+
+        // Bin centre of the value at rank `index` (0-based, ascending) counting from firstBin
+        double valueAt(int firstBin, uint64_t index) const
+        {
+            for (int b = firstBin; b < NUM_BINS; ++b)
+            {
+                const uint64_t inBin = counts[static_cast<size_t>(b)];
+                if (index < inBin)
+                    return binCentre(b);
+                index -= inBin;
+            }
+            return binCentre(NUM_BINS - 1);
+        }
+
+        std::array<uint32_t, NUM_BINS> counts{};
+        std::array<double, NUM_BINS> energies{};
+    };
+
+    // BS.1770-4 K-weighting, re-derived for the sample rate (same analogue prototypes as the 48k table)
+    void setKWeighting(double sampleRate)
+    {
+        const double pi = juce::MathConstants<double>::pi;
+
+        // High-frequency shelf, +4 dB above ~1.7 kHz
+        {
+            const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+            const double k = std::tan(pi * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            shelf.setCoefficients({static_cast<float>((vh + vb * k / q + k * k) / a0),
+                                   static_cast<float>(2.0 * (k * k - vh) / a0),
+                                   static_cast<float>((vh - vb * k / q + k * k) / a0),
+                                   1.0f,
+                                   static_cast<float>(2.0 * (k * k - 1.0) / a0),
+                                   static_cast<float>((1.0 - k / q + k * k) / a0)});
+        }
+
+        // RLB high-pass at ~38 Hz
+        {
+            const double f0 = 38.13547087602444, q = 0.5003270373238773;
+            const double k = std::tan(pi * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+            highPass.setCoefficients({1.0f, -2.0f, 1.0f, 1.0f,
+                                      static_cast<float>(2.0 * (k * k - 1.0) / a0),
+                                      static_cast<float>((1.0 - k / q + k * k) / a0)});
+        }
+    }
+
+    void measureChunk(const float* left, const float* right, int n)
+    {
+        float* weightedLeft = weighted[0].data();
+        float* weightedRight = weighted[1].data();
+        for (int i = 0; i < n; ++i)
+        {
+            LaneBiquad<2>::Lanes s{left[i], right[i]};
+            shelf.process(s);
+            highPass.process(s);
+            weightedLeft[i] = s[0];
+            weightedRight[i] = s[1];
+        }
+
+        const std::array<const float*, 2> input{left, right};
+        for (size_t ch = 0; ch < 2; ++ch)
+        {
+            stepSum[ch] += sumOfSquares(weighted[ch].data(), n);
+            pendingSquares[ch] += sumOfSquares(input[ch], n);
+            const float samplePeak = maxAbs(input[ch], n);
+            pendingPeak[ch] = std::max(pendingPeak[ch], samplePeak);
+            pendingTruePeak[ch] = std::max({pendingTruePeak[ch], samplePeak, interpolatedPeak(ch, input[ch], n)});
+        }
+        pendingSamples += n;
+    }
+
+    // Polyphase interpolation of one chunk. Phase 0 is a plain delay of the input, so its
+    // peak is the sample peak; phases 1-3 are a fixed 12-tap FIR each, vectorised across i
+    float interpolatedPeak(size_t channel, const float* x, int n)
+    {
+        auto& extended = truePeakInput[channel]; // HISTORY samples of the previous chunk, then this one
+        std::copy(x, x + n, extended.begin() + HISTORY);
+
+        constexpr int taps = TruePeakDetector::TAPS;
+        const float* oldest = extended.data();
+        float* y = interpolated.data();
+        float peak = 0.0f;
+        for (size_t p = 1; p < truePeakCoeffs.size(); ++p)
+        {
+            const auto& phase = truePeakCoeffs[p];
+            for (int i = 0; i < n; ++i)
+            {
+                float acc = 0.0f;
+                for (int j = 0; j < taps; ++j)
+                    acc += phase[static_cast<size_t>(taps - 1 - j)] * oldest[i + j];
+                y[i] = acc;
+            }
+            peak = std::max(peak, maxAbs(y, n));
+        }
+
+        std::copy(extended.begin() + n, extended.begin() + n + HISTORY, extended.begin());
+        return peak;
+    }
+
+    // Eight independent accumulators so the reductions vectorise without reassociation flags
+    static float sumOfSquares(const float* x, int n)
+    {
+        std::array<float, 8> acc{};
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            for (int k = 0; k < 8; ++k)
+                acc[static_cast<size_t>(k)] += x[i + k] * x[i + k];
+        float sum = 0.0f;
+        for (; i < n; ++i)
+            sum += x[i] * x[i];
+        for (float a : acc)
+            sum += a;
+        return sum;
+    }
+
+    static float maxAbs(const float* x, int n)
+    {
+        std::array<float, 8> acc{};
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            for (int k = 0; k < 8; ++k)
+                acc[static_cast<size_t>(k)] = std::max(acc[static_cast<size_t>(k)], std::abs(x[i + k]));
+        float peak = 0.0f;
+        for (; i < n; ++i)
+            peak = std::max(peak, std::abs(x[i]));
+        for (float a : acc)
+            peak = std::max(peak, a);
+        return peak;
+    }
+
+    void endFrame()
+    {
+        frameSamples = 0;
+        if (++stepFrames == FRAMES_PER_STEP)
+        {
+            stepFrames = 0;
+            endStep();
+        }
+
+        Frame frame;
+        for (size_t ch = 0; ch < 2; ++ch)
+        {
+            frame.peak[ch] = pendingPeak[ch];
+            frame.rms[ch] = static_cast<float>(std::sqrt(pendingSquares[ch] / static_cast<double>(pendingSamples)));
+            frame.truePeak[ch] = pendingTruePeak[ch];
+            maxTruePeakDb = std::max(maxTruePeakDb, juce::Decibels::gainToDecibels(pendingTruePeak[ch], SILENCE));
+        }
+        frame.momentary = momentary;
+        frame.shortTerm = shortTerm;
+        frame.integrated = integrated;
+        frame.range = range;
+        frame.maxTruePeak = maxTruePeakDb;
+
+        // On a full queue keep accumulating; the next frame carries these samples too
+        if (frames.push(frame))
+            clearPending();
+    }
+
+    void endStep()
+    {
+        // Channel weights are 1 for L and R, so the block energy is the sum of the mean squares
+        stepEnergies[static_cast<size_t>(stepIndex)] = (stepSum[0] + stepSum[1]) / static_cast<double>(stepLength);
+        stepSum = {};
+        stepIndex = (stepIndex + 1) % SHORT_TERM_STEPS;
+        stepsMeasured = std::min(stepsMeasured + 1, SHORT_TERM_STEPS);
+
+        double momentaryEnergy = 0.0, shortTermEnergy = 0.0;
+        for (int s = 0; s < SHORT_TERM_STEPS; ++s)
+        {
+            const double e = stepEnergies[static_cast<size_t>((stepIndex + SHORT_TERM_STEPS - 1 - s) % SHORT_TERM_STEPS)];
+            shortTermEnergy += e;
+            if (s < MOMENTARY_STEPS)
+                momentaryEnergy += e;
+        }
+        momentaryEnergy /= MOMENTARY_STEPS;
+        shortTermEnergy /= SHORT_TERM_STEPS;
+        momentary = static_cast<float>(toLufs(momentaryEnergy));
+        shortTerm = static_cast<float>(toLufs(shortTermEnergy));
+
+        // 400 ms gating blocks overlap by 75%, i.e. one per step
+        if (stepsMeasured >= MOMENTARY_STEPS)
+        {
+            blocks.add(momentaryEnergy);
+            const double relativeGate = toLufs(blocks.meanEnergy(0)) - 10.0;
+            integrated = static_cast<float>(toLufs(blocks.meanEnergy(Histogram::firstBinAbove(relativeGate))));
+        }
+
+        if (stepsMeasured >= SHORT_TERM_STEPS)
+        {
+            shortTermValues.add(shortTermEnergy);
+            const int first = Histogram::firstBinAbove(toLufs(shortTermValues.meanEnergy(0)) - 20.0);
+            const uint64_t n = shortTermValues.count(first);
+            if (n > 0)
+            {
+                const auto rank = [n](double p) { return static_cast<uint64_t>(static_cast<double>(n - 1) * p + 0.5); };
+                range = static_cast<float>(shortTermValues.valueAt(first, rank(0.95))
+                                           - shortTermValues.valueAt(first, rank(0.10)));
+            }
+        }
+    }
+
+    void clearPending()
+    {
+        pendingPeak = {};
+        pendingTruePeak = {};
+        pendingSquares = {};
+        pendingSamples = 0;
+    }
+
+    int frameLength = 960, stepLength = 4800, maxChunk = 512;
+    int frameSamples = 0, stepFrames = 0;
+
+    LaneBiquad<2> shelf, highPass;
+    std::array<std::vector<float>, 2> weighted;
+    std::array<double, 2> stepSum{};
+    std::array<double, SHORT_TERM_STEPS> stepEnergies{};
+    int stepIndex = 0, stepsMeasured = 0;
+    Histogram blocks, shortTermValues;
+
+    const TruePeakDetector::Coefficients truePeakCoeffs = TruePeakDetector::makeCoefficients();
+    std::array<std::vector<float>, 2> truePeakInput;
+    std::vector<float> interpolated;
+
+    // Accumulated since the last frame that made it into the queue
+    std::array<float, 2> pendingPeak{}, pendingTruePeak{};
+    std::array<double, 2> pendingSquares{};
+    int64_t pendingSamples = 0;
+
+    float momentary = SILENCE, shortTerm = SILENCE, integrated = SILENCE, range = 0.0f;
+    float maxTruePeakDb = SILENCE;
+
+    SpscQueue<Frame, 256> frames;
+};
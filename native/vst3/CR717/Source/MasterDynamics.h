@@ -1,41 +1,135 @@
 #pragma once
 
 #include <juce_dsp/juce_dsp.h>
+#include "ClipCurves.h"
+#include "Crossover.h"
+#include "LookaheadLimiter.h"
+
+/**
+ * Mean-square level detector, O(1) per sample at any window length.
+ * Window: exact sliding window from a running sum, re-summed once per lap so float
+ * drift can't build up (amortised O(1)).
+ * Smooth: two cascaded one-poles on x^2 with the same mean delay as the window
+ * (tau = window / 4); no ring buffer, slightly softer response to bursts.
+ */
+class RmsDetector
+{
+public:
+    enum Mode { Window = 0, Smooth };
+
+    void prepare(int windowSamples)
+    {
+        ring.assign(static_cast<size_t>(juce::jmax(1, windowSamples)), 0.0f);
+        smoothCoeff = std::exp(-4.0f / static_cast<float>(ring.size()));
+        reset();
+    }
+
+    void setMode(int newMode) { mode = newMode; }
+
+    // Takes x^2, returns the mean square
+    float process(float squared)
+    {
+        if (mode == Smooth)
+        {
+            stage1 = squared + smoothCoeff * (stage1 - squared);
+            stage2 = stage1 + smoothCoeff * (stage2 - stage1);
+            return stage2;
+        }
+
+        auto& slot = ring[static_cast<size_t>(pos)];
+        sum += static_cast<double>(squared) - slot;
+        slot = squared;
+
+        if (++pos == static_cast<int>(ring.size()))
+        {
+            pos = 0;
+            sum = 0.0;
+            for (auto v : ring)
+                sum += v;
+        }
+
+        return static_cast<float>(juce::jmax(0.0, sum) / static_cast<double>(ring.size()));
+    }
+
+    void reset()
+    {
+        std::fill(ring.begin(), ring.end(), 0.0f);
+        sum = 0.0;
+        pos = 0;
+        stage1 = stage2 = 0.0f;
+    }
+
+private:
+    std::vector<float> ring;
+    double sum = 0.0;
+    int pos = 0;
+    int mode = Window;
+    float smoothCoeff = 0.0f, stage1 = 0.0f, stage2 = 0.0f;
+};
 
 class MasterDynamics
 {
 public:
+    // How the compressor's two detector lanes are fed and how their gains are applied
+    enum LinkMode
+    {
+        MonoSum = 0, // (L+R)/2 drives one gain for both channels
+        MaxLinked,   // L and R detected separately, the louder one sets a shared gain
+        Unlinked,    // L and R compressed independently
+        MidSide      // M and S detected and compressed independently
+    };
+
+    // Single band, or low / mid / high through a Linkwitz-Riley crossover, each band with
+    // its own detector and envelope
+    enum BandMode { SingleBand = 0, ThreeBand };
+
+    // Everything process() needs is sized here; processing itself never allocates
     void prepare(double sampleRate, int maxBlockSize)
     {
         spec = {sampleRate, static_cast<juce::uint32>(maxBlockSize), 2};
+        maxBlock = maxBlockSize;
         
-        // RMS detector window (10ms)
-        rmsWindowSize = static_cast<int>(sampleRate * 0.01);
-        rmsBuffer.resize(rmsWindowSize * 2, 0.0f);
-        rmsIndex = 0;
-        
-        // Compressor lookahead delay
-        lookaheadDelay.prepare(spec);
-        lookaheadDelay.setMaximumDelayInSamples(static_cast<int>(sampleRate * 0.005)); // 5ms max
+        // Compressor bands: RMS detector window (10ms) per detector lane, SC HPF (12dB/oct = 2-pole Butterworth)
+        currentScHpf = 80.0f;
+        for (auto& band : compBands)
+        {
+            for (auto& detector : band.rmsDetectors)
+                detector.prepare(static_cast<int>(sampleRate * 0.01));
+            band.scHpf.setCoefficients(juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(sampleRate, currentScHpf));
+            band.reset();
+        }
         
-        // SC HPF (12dB/oct = 2-pole Butterworth)
-        scHpf.prepare(spec);
-        scHpf.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 80.0f);
+        // 3-band mode: crossover outputs (L/R per band), two gain lanes per band
+        crossover.prepare(sampleRate);
+        bandBuffer.setSize(2 * ThreeBandCrossover::NUM_BANDS, maxBlockSize);
+        gainLanes.setSize(2 * ThreeBandCrossover::NUM_BANDS, maxBlockSize);
         
-        // Limiter lookahead
-        limiterLookahead.prepare(spec);
-        limiterLookahead.setMaximumDelayInSamples(static_cast<int>(sampleRate * 0.01)); // 10ms max
+        // Compressor lookahead delay, one channel per band output
+        lookaheadDelay.prepare({sampleRate, static_cast<juce::uint32>(maxBlockSize), 2 * ThreeBandCrossover::NUM_BANDS});
+        lookaheadDelay.setMaximumDelayInSamples(static_cast<int>(sampleRate * 0.005)); // 5ms max
         
-        // True-peak oversampling (4x, linear-phase FIR)
+        // True-peak oversampling (4x, linear-phase FIR; integer latency so it can be reported to the host)
         oversampling = std::make_unique<juce::dsp::Oversampling<float>>(2, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple);
+        oversampling->setUsingIntegerLatency(true);
         oversampling->initProcessing(maxBlockSize);
         
+        // Limiter lookahead (10ms max), sized for running inside the oversampled section
+        limiter.prepare(static_cast<int>(std::ceil(sampleRate * 0.01)) * static_cast<int>(oversampling->getOversamplingFactor()));
+        
         // Clipper oversampling (2x and 4x)
         clipperOversampling2x = std::make_unique<juce::dsp::Oversampling<float>>(2, 1, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple);
+        clipperOversampling2x->setUsingIntegerLatency(true);
         clipperOversampling2x->initProcessing(maxBlockSize);
         clipperOversampling4x = std::make_unique<juce::dsp::Oversampling<float>>(2, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple);
+        clipperOversampling4x->setUsingIntegerLatency(true);
         clipperOversampling4x->initProcessing(maxBlockSize);
         
+        // Clipper dry path, delayed to line up with the oversampled wet path
+        clipperDryDelay.prepare(spec);
+        clipperDryDelay.setMaximumDelayInSamples(juce::jmax(getOversamplerLatency(clipperOversampling2x.get()),
+                                                            getOversamplerLatency(clipperOversampling4x.get())) + 1);
+        dryBuffer.setSize(2, maxBlockSize);
+        
         // Smoothed parameters
         smoothedThreshold.reset(sampleRate, 0.02);
         smoothedRatio.reset(sampleRate, 0.02);
@@ -43,7 +137,10 @@ public:
         smoothedRelease.reset(sampleRate, 0.02);
         smoothedKnee.reset(sampleRate, 0.02);
         smoothedMakeup.reset(sampleRate, 0.02);
+        smoothedCompMix.reset(sampleRate, 0.02);
         smoothedScHpf.reset(sampleRate, 0.05);
+        smoothedCrossoverLow.reset(sampleRate, 0.05);
+        smoothedCrossoverHigh.reset(sampleRate, 0.05);
         smoothedLimiterCeiling.reset(sampleRate, 0.02);
         smoothedLimiterRelease.reset(sampleRate, 0.02);
         smoothedLimiterKnee.reset(sampleRate, 0.02);
@@ -52,13 +149,12 @@ public:
         smoothedClipperMix.reset(sampleRate, 0.02);
         
         // Auto-makeup RMS tracking (300ms)
-        autoMakeupWindowSize = static_cast<int>(sampleRate * 0.3);
-        autoMakeupBuffer.resize(autoMakeupWindowSize * 2, 0.0f);
-        autoMakeupIndex = 0;
+        autoMakeupDetector.prepare(static_cast<int>(sampleRate * 0.3));
         
         gainReduction = 0.0f;
-        envelopeState = 0.0f;
-        limiterEnvelope = 1.0f;
+        bandGainReduction.fill(0.0f);
+        compDryGain = 1.0f - smoothedCompMix.getCurrentValue() * 0.01f;
+        compWetGain = smoothedCompMix.getCurrentValue() * 0.01f * juce::Decibels::decibelsToGain(smoothedMakeup.getCurrentValue());
     }
 
     void setThreshold(float db) { smoothedThreshold.setTargetValue(db); }
@@ -68,8 +164,23 @@ public:
     void setKnee(float db) { smoothedKnee.setTargetValue(db); }
     void setMakeup(float db) { smoothedMakeup.setTargetValue(db); }
     void setAutoMakeup(bool enabled) { autoMakeupEnabled = enabled; }
+    void setMix(float percent) { smoothedCompMix.setTargetValue(percent); } // below 100% blends in the uncompressed signal
     void setScHpfFreq(float hz) { smoothedScHpf.setTargetValue(hz); }
     void setDetectorMode(bool useRms) { rmsMode = useRms; }
+    void setRmsDetectorType(int type) // RmsDetector::Mode
+    {
+        for (auto& band : compBands)
+            for (auto& detector : band.rmsDetectors)
+                detector.setMode(type);
+    }
+    void setLinkMode(int mode) { linkMode = mode; } // LinkMode
+    void setBandMode(int mode) { bandMode = mode; } // BandMode
+    void setCrossoverFrequencies(float lowHz, float highHz)
+    {
+        smoothedCrossoverLow.setTargetValue(lowHz);
+        smoothedCrossoverHigh.setTargetValue(highHz);
+    }
+    void setBandThresholdOffset(int band, float db) { compBands[static_cast<size_t>(band)].thresholdOffset = db; } // ThreeBandCrossover::Band
     void setLookahead(float ms) { lookaheadMs = ms; }
     void setLimiterCeiling(float db) { smoothedLimiterCeiling.setTargetValue(db); }
     void setLimiterRelease(float ms) { smoothedLimiterRelease.setTargetValue(ms); }
@@ -79,204 +190,550 @@ public:
     void setClipperDrive(float db) { smoothedClipperDrive.setTargetValue(db); }
     void setClipperOutput(float db) { smoothedClipperOutput.setTargetValue(db); }
     void setClipperMix(float percent) { smoothedClipperMix.setTargetValue(percent); }
-    void setClipperCurve(int curve) { clipperCurve = curve; } // 0=tanh, 1=atan, 2=poly
+    void setClipperCurve(int curve) { clipperCurve = curve; clipperAdaa.setCurve(curve); } // 0=tanh, 1=atan, 2=poly
+    void setClipperAntialias(int order) { clipperAdaa.setOrder(order); } // 0=off, 1=ADAA 1st, 2=ADAA 2nd
     void setClipperOversampling(int factor) { clipperOversamplingFactor = factor; } // 0=off, 1=2x, 2=4x
 
+    // ClipperAndLimiter runs both back to back, sharing one 4x section when both are oversampled
+    enum class Stage { Compressor, Clipper, Limiter, ClipperAndLimiter };
+
     void process(juce::AudioBuffer<float>& buffer, bool compEnabled, bool limiterEnabled, bool clipperEnabled)
     {
         juce::ScopedNoDenormals noDenormals;
-        const int blockSize = buffer.getNumSamples();
-        // Ensure oversamplers are provisioned for this block size
-        if (oversampling)
-            oversampling->initProcessing(blockSize);
-        if (clipperOversampling2x)
-            clipperOversampling2x->initProcessing(blockSize);
-        if (clipperOversampling4x)
-            clipperOversampling4x->initProcessing(blockSize);
         
         if (compEnabled)
-            processCompressor(buffer);
+            processStage(Stage::Compressor, buffer);
         
-        if (clipperEnabled)
-            processClipper(buffer);
+        if (clipperEnabled && limiterEnabled)
+            processStage(Stage::ClipperAndLimiter, buffer);
+        else if (clipperEnabled)
+            processStage(Stage::Clipper, buffer);
+        else if (limiterEnabled)
+            processStage(Stage::Limiter, buffer);
+    }
+
+    // True when the clipper and limiter can run in a single oversampled section
+    bool canShareOversampling() const
+    {
+        return clipperOversamplingFactor > 0 && limiterOversamplingEnabled && oversampling != nullptr;
+    }
+
+    // Runs one stage on its own, so callers can reorder the chain (see FxGraph).
+    // Blocks longer than the prepared size are split so the oversamplers never need re-initialising.
+    void processStage(Stage stage, juce::AudioBuffer<float>& buffer)
+    {
+        const int numSamples = buffer.getNumSamples();
         
-        if (limiterEnabled)
-            processTruePeakLimiter(buffer);
+        if (numSamples <= maxBlock)
+        {
+            processStageChunk(stage, buffer);
+            return;
+        }
+        
+        for (int start = 0; start < numSamples; start += maxBlock)
+        {
+            // Refers to the host data; AudioBuffer keeps channel pointers for small channel counts inline
+            juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                                           start, juce::jmin(maxBlock, numSamples - start));
+            processStageChunk(stage, chunk);
+        }
     }
 
     float getGainReduction() const { return gainReduction; }
+    
+    // Per-band compressor gain reduction in dB (ThreeBandCrossover::Band); in single-band
+    // mode every band reports the overall reduction
+    float getBandGainReduction(int band) const { return bandGainReduction[static_cast<size_t>(band)]; }
+
+    // Total delay of the chain for the current settings, in samples at the host rate.
+    // clipperFeedsLimiter: the limiter directly follows the clipper (ClipperAndLimiter stage)
+    int getLatencySamples(bool compEnabled, bool limiterEnabled, bool clipperEnabled, bool clipperFeedsLimiter = true) const
+    {
+        int latency = 0;
+        
+        if (compEnabled)
+            latency += static_cast<int>(spec.sampleRate * lookaheadMs * 0.001f);
+        
+        const bool shared = clipperEnabled && limiterEnabled && clipperFeedsLimiter && canShareOversampling();
+        if (clipperEnabled && clipperOversamplingFactor > 0 && !shared)
+            latency += getOversamplerLatency(getClipperOversampler());
+        
+        if (clipperEnabled && clipperOversamplingFactor == 0)
+            latency += clipperAdaa.getLatencySamples();
+        
+        if (limiterEnabled)
+        {
+            latency += getLimiterLookaheadSamples();
+            if (limiterOversamplingEnabled)
+                latency += getOversamplerLatency(oversampling.get());
+            else
+                latency += TruePeakDetector::DELAY;
+        }
+        
+        return latency;
+    }
+
+    // Most the compressor and clipper can delay the signal, in samples at the host rate
+    int getMaxPreLimiterLatencySamples() const
+    {
+        // 5 ms of compressor lookahead, then the slower oversampler (second-order ADAA is one sample)
+        return static_cast<int>(spec.sampleRate * 0.005) + juce::jmax(getOversamplerLatency(clipperOversampling2x.get()),
+                                                                      getOversamplerLatency(clipperOversampling4x.get()), 1);
+    }
 
     void reset()
     {
         lookaheadDelay.reset();
-        limiterLookahead.reset();
-        scHpf.reset();
+        limiter.reset();
+        clipperDryDelay.reset();
+        crossover.reset();
+        for (auto& band : compBands)
+            band.reset();
         if (oversampling)
             oversampling->reset();
         if (clipperOversampling2x)
             clipperOversampling2x->reset();
         if (clipperOversampling4x)
             clipperOversampling4x->reset();
-        std::fill(rmsBuffer.begin(), rmsBuffer.end(), 0.0f);
-        std::fill(autoMakeupBuffer.begin(), autoMakeupBuffer.end(), 0.0f);
-        rmsIndex = 0;
-        autoMakeupIndex = 0;
+        autoMakeupDetector.reset();
+        clipperAdaa.reset();
+        sharedDryHistory.fill(0.0f);
+        autoMakeupMeanSquare = 0.0f;
         gainReduction = 0.0f;
-        envelopeState = 0.0f;
-        limiterEnvelope = 1.0f;
+        bandGainReduction.fill(0.0f);
     }
 
 private:
+    // Detector, gain computer and envelope state of one compressor band (the whole
+    // signal in single-band mode)
+    struct CompressorBand
+    {
+        LaneBiquad<2> scHpf;
+        std::array<RmsDetector, 2> rmsDetectors;
+        std::array<float, 2> envelope{1.0f, 1.0f}; // per detector lane
+        float thresholdOffset = 0.0f;
+        
+        void reset()
+        {
+            scHpf.reset();
+            for (auto& detector : rmsDetectors)
+                detector.reset();
+            envelope = {1.0f, 1.0f};
+        }
+    };
+    
+    // Gain computer settings for one block: the smoothers' values ramp linearly across it
+    struct GainRamp
+    {
+        float threshold = 0.0f, thresholdStep = 0.0f;
+        float ratio = 1.0f, ratioStep = 0.0f;
+        float knee = 0.0f, kneeStep = 0.0f;
+        float attackCoeff = 0.0f, releaseCoeff = 0.0f;
+    };
+    
+    static void rampFrom(juce::SmoothedValue<float>& smoothed, int numSamples, float& start, float& step)
+    {
+        start = smoothed.getCurrentValue();
+        step = (smoothed.skip(numSamples) - start) / static_cast<float>(numSamples);
+    }
+
+    void processStageChunk(Stage stage, juce::AudioBuffer<float>& buffer)
+    {
+        switch (stage)
+        {
+            case Stage::Compressor: processCompressor(buffer); break;
+            case Stage::Clipper:    processClipper(buffer); break;
+            case Stage::Limiter:    processTruePeakLimiter(buffer); break;
+            case Stage::ClipperAndLimiter:
+                if (canShareOversampling())
+                {
+                    processSharedClipperLimiter(buffer);
+                }
+                else
+                {
+                    processClipper(buffer);
+                    processTruePeakLimiter(buffer);
+                }
+                break;
+        }
+    }
+
+    static int getOversamplerLatency(const juce::dsp::Oversampling<float>* os)
+    {
+        return os != nullptr ? static_cast<int>(std::lround(os->getLatencyInSamples())) : 0;
+    }
+
+    juce::dsp::Oversampling<float>* getClipperOversampler() const
+    {
+        return clipperOversamplingFactor == 1 ? clipperOversampling2x.get() : clipperOversampling4x.get();
+    }
+
+    // Static gain curve in dB (<= 0): a knee of kneeDb centred on the threshold, written
+    // with clamps instead of branches so the loops over it vectorise.
+    // A hard knee uses a vanishingly small knee (at most 0.0005 dB off the exact corner).
+    static float computeGainDb(float levelDb, float threshold, float ratio, float kneeDb)
+    {
+        const float width = kneeDb > 0.1f ? kneeDb : 1.0e-3f;
+        const float over = levelDb - threshold;
+        const float inKnee = juce::jlimit(0.0f, width, over + 0.5f * width);
+        const float aboveKnee = juce::jmax(0.0f, over - 0.5f * width);
+        return (1.0f / ratio - 1.0f) * (inKnee * inKnee / (2.0f * width) + aboveKnee);
+    }
+
+    // Detector lanes -> level -> gain curve -> envelope for one band, as a series of passes
+    // over the block. The dB conversions and gain curve have no state and vectorise across
+    // time; the recursive parts (sidechain filter, RMS, envelope) step both lanes together.
+    // Leaves each lane's envelope in envelopeA / envelopeB.
+    void computeBandEnvelope(CompressorBand& band, const float* left, const float* right, float* envelopeA, float* envelopeB,
+                             int numSamples, const GainRamp& ramp, bool sidechainFilter)
+    {
+        float* laneA = envelopeA;
+        float* laneB = envelopeB;
+        
+        // Detector lanes
+        switch (linkMode)
+        {
+            case MaxLinked:
+            case Unlinked:
+                std::copy(left, left + numSamples, laneA);
+                std::copy(right, right + numSamples, laneB);
+                break;
+            case MidSide:
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    laneA[i] = 0.5f * (left[i] + right[i]);
+                    laneB[i] = 0.5f * (left[i] - right[i]);
+                }
+                break;
+            default:
+                for (int i = 0; i < numSamples; ++i)
+                    laneA[i] = laneB[i] = 0.5f * (left[i] + right[i]);
+                break;
+        }
+        
+        // SC HPF
+        if (sidechainFilter)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                LaneBiquad<2>::Lanes x{laneA[i], laneB[i]};
+                band.scHpf.process(x);
+                laneA[i] = x[0];
+                laneB[i] = x[1];
+            }
+        }
+        
+        // Mono sum feeds the same signal to both lanes, so the per-lane passes below only
+        // need to run once
+        const std::array<float*, 2> lanes{laneA, laneB};
+        const size_t numLanes = linkMode == MonoSum ? 1 : 2;
+        
+        // Level detection (RMS or Peak), in dB
+        for (size_t k = 0; k < numLanes; ++k)
+        {
+            float* lane = lanes[k];
+            if (rmsMode)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    lane[i] = band.rmsDetectors[k].process(lane[i] * lane[i]);
+                for (int i = 0; i < numSamples; ++i)
+                    lane[i] = std::sqrt(lane[i]);
+            }
+            
+            for (int i = 0; i < numSamples; ++i)
+                lane[i] = FastMath::gainToDecibels(std::abs(lane[i]) + 1e-6f);
+        }
+        
+        if (linkMode == MaxLinked)
+            for (int i = 0; i < numSamples; ++i)
+                laneA[i] = laneB[i] = juce::jmax(laneA[i], laneB[i]);
+        
+        // Gain computer with soft knee, to a target gain per lane
+        const float threshold = ramp.threshold + band.thresholdOffset;
+        for (size_t k = 0; k < numLanes; ++k)
+        {
+            float* lane = lanes[k];
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float t = static_cast<float>(i + 1);
+                lane[i] = FastMath::decibelsToGain(computeGainDb(lane[i], threshold + ramp.thresholdStep * t,
+                                                                 ramp.ratio + ramp.ratioStep * t,
+                                                                 ramp.knee + ramp.kneeStep * t));
+            }
+        }
+        
+        if (numLanes == 1)
+            std::copy(laneA, laneA + numSamples, laneB);
+        
+        // Envelope follower, both lanes per step (instant switch between attack and release)
+        auto envelope = band.envelope;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const std::array<float, 2> target{laneA[i], laneB[i]};
+            for (size_t k = 0; k < 2; ++k)
+            {
+                const float coeff = target[k] < envelope[k] ? ramp.attackCoeff : ramp.releaseCoeff;
+                envelope[k] = target[k] + coeff * (envelope[k] - target[k]);
+            }
+            laneA[i] = envelope[0];
+            laneB[i] = envelope[1];
+        }
+        band.envelope = envelope;
+    }
+    
+    // Lookahead: delays one stereo pair on delay channels firstChannel, firstChannel + 1
+    void delayForLookahead(float* left, float* right, int firstChannel, int numSamples, bool stereo)
+    {
+        for (int ch = 0; ch < (stereo ? 2 : 1); ++ch)
+        {
+            float* data = ch == 0 ? left : right;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                lookaheadDelay.pushSample(firstChannel + ch, data[i]);
+                data[i] = lookaheadDelay.popSample(firstChannel + ch);
+            }
+        }
+    }
+    
+    // Applies the lane gains to L/R, or to M/S in mid/side mode
+    void applyLaneGains(float* left, float* right, const float* gainA, const float* gainB, int numSamples, bool stereo) const
+    {
+        if (linkMode == MidSide && stereo)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float m = 0.5f * (left[i] + right[i]) * gainA[i];
+                const float s = 0.5f * (left[i] - right[i]) * gainB[i];
+                left[i] = m + s;
+                right[i] = m - s;
+            }
+        }
+        else
+        {
+            juce::FloatVectorOperations::multiply(left, gainA, numSamples);
+            if (stereo)
+                juce::FloatVectorOperations::multiply(right, gainB, numSamples);
+        }
+    }
+    
     void processCompressor(juce::AudioBuffer<float>& buffer)
     {
         const int numSamples = buffer.getNumSamples();
-        const int numChannels = buffer.getNumChannels();
+        const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
+        if (numChannels == 0)
+            return;
         
-        // Update SC HPF if needed
-        float targetScHpf = smoothedScHpf.getNextValue();
+        // Update SC HPF if needed (single-band only: in 3-band mode the crossover already
+        // keeps the low end out of the upper bands' detectors)
+        float targetScHpf = smoothedScHpf.skip(numSamples);
         if (std::abs(targetScHpf - currentScHpf) > 0.1f)
         {
             currentScHpf = targetScHpf;
-            scHpf.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(spec.sampleRate, currentScHpf);
+            compBands[0].scHpf.setCoefficients(juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(spec.sampleRate, currentScHpf));
         }
         
+        // Switching topology: band delays and detectors hold state for the other one
+        const bool multiband = bandMode == ThreeBand;
+        if (multiband != multibandActive)
+        {
+            multibandActive = multiband;
+            lookaheadDelay.reset();
+            crossover.reset();
+            for (auto& band : compBands)
+                band.reset();
+        }
+        
+        const float crossoverLow = smoothedCrossoverLow.skip(numSamples);
+        const float crossoverHigh = smoothedCrossoverHigh.skip(numSamples);
+        if (multiband)
+            crossover.setFrequencies(crossoverLow, crossoverHigh);
+        
         // Lookahead delay setup
         int lookaheadSamples = static_cast<int>(spec.sampleRate * lookaheadMs * 0.001f);
         lookaheadDelay.setDelay(static_cast<float>(lookaheadSamples));
         
-        // Attack/Release coefficients
-        float attackCoeff = std::exp(-1.0f / (smoothedAttack.getNextValue() * 0.001f * spec.sampleRate));
-        float releaseCoeff = std::exp(-1.0f / (smoothedRelease.getNextValue() * 0.001f * spec.sampleRate));
+        // Gain computer ramps, attack/release coefficients
+        GainRamp ramp;
+        rampFrom(smoothedThreshold, numSamples, ramp.threshold, ramp.thresholdStep);
+        rampFrom(smoothedRatio, numSamples, ramp.ratio, ramp.ratioStep);
+        rampFrom(smoothedKnee, numSamples, ramp.knee, ramp.kneeStep);
+        ramp.attackCoeff = std::exp(-1.0f / (smoothedAttack.skip(numSamples) * 0.001f * static_cast<float>(spec.sampleRate)));
+        ramp.releaseCoeff = std::exp(-1.0f / (smoothedRelease.skip(numSamples) * 0.001f * static_cast<float>(spec.sampleRate)));
         
-        float inputRms = 0.0f, outputRms = 0.0f;
+        // A mono bus reads its one channel as both L and R
+        const bool stereo = numChannels > 1;
+        float* left = buffer.getWritePointer(0);
+        float* right = stereo ? buffer.getWritePointer(1) : left;
         
-        for (int i = 0; i < numSamples; ++i)
+        // Track input RMS for auto-makeup
+        if (autoMakeupEnabled)
         {
-            // Detector path: stereo sum
-            float detectorSample = 0.0f;
-            for (int ch = 0; ch < numChannels; ++ch)
-                detectorSample += buffer.getSample(ch, i);
-            detectorSample /= numChannels;
-            
-            // SC HPF
-            float scFiltered = scHpf.processSample(detectorSample);
-            
-            // Level detection (RMS or Peak)
-            float level = 0.0f;
-            if (rmsMode)
-            {
-                // RMS window
-                int idx = rmsIndex % rmsWindowSize;
-                rmsBuffer[idx] = scFiltered * scFiltered;
-                float sum = 0.0f;
-                for (int j = 0; j < rmsWindowSize; ++j)
-                    sum += rmsBuffer[j];
-                level = std::sqrt(sum / rmsWindowSize);
-                rmsIndex++;
-            }
-            else
+            for (int i = 0; i < numSamples; ++i)
             {
-                level = std::abs(scFiltered);
+                const float mid = 0.5f * (left[i] + right[i]);
+                autoMakeupMeanSquare = autoMakeupDetector.process(mid * mid);
             }
+        }
+        
+        // Split, then one detector / gain computer / envelope pass per band
+        const int numBands = multiband ? ThreeBandCrossover::NUM_BANDS : 1;
+        if (multiband)
+        {
+            std::array<float*, 2 * ThreeBandCrossover::NUM_BANDS> bands{};
+            for (size_t ch = 0; ch < bands.size(); ++ch)
+                bands[ch] = bandBuffer.getWritePointer(static_cast<int>(ch));
+            crossover.process(left, right, bands, numSamples);
+        }
+        
+        for (int b = 0; b < numBands; ++b)
+        {
+            const float* bandLeft = multiband ? bandBuffer.getReadPointer(2 * b) : left;
+            const float* bandRight = multiband ? bandBuffer.getReadPointer(2 * b + 1) : right;
+            computeBandEnvelope(compBands[static_cast<size_t>(b)], bandLeft, bandRight,
+                                gainLanes.getWritePointer(2 * b), gainLanes.getWritePointer(2 * b + 1),
+                                numSamples, ramp, !multiband);
+        }
+        
+        // The deepest lane drives the meters; auto-makeup compensates the average reduction
+        float meterGain = 1.0f, averageGain = 0.0f;
+        for (int b = 0; b < numBands; ++b)
+        {
+            const auto& envelope = compBands[static_cast<size_t>(b)].envelope;
+            const float bandGain = juce::jmin(envelope[0], envelope[1]);
+            bandGainReduction[static_cast<size_t>(b)] = juce::Decibels::gainToDecibels(bandGain);
+            meterGain = juce::jmin(meterGain, bandGain);
+            averageGain += 0.5f * (envelope[0] + envelope[1]) / static_cast<float>(numBands);
+        }
+        if (!multiband)
+            bandGainReduction.fill(bandGainReduction[0]);
+        
+        // Auto-makeup calculation
+        float makeup = smoothedMakeup.skip(numSamples);
+        if (autoMakeupEnabled && numSamples > 0)
+        {
+            float inRms = std::sqrt(autoMakeupMeanSquare);
+            float outRms = inRms * averageGain;
             
-            float levelDb = juce::Decibels::gainToDecibels(level + 1e-6f);
-            
-            // Gain computer with soft knee
-            float threshold = smoothedThreshold.getCurrentValue();
-            float ratio = smoothedRatio.getCurrentValue();
-            float knee = smoothedKnee.getCurrentValue();
-            
-            float gr = 0.0f;
-            if (knee > 0.1f)
+            if (outRms > 1e-6f)
             {
-                // Soft knee
-                float kneeStart = threshold - knee * 0.5f;
-                float kneeEnd = threshold + knee * 0.5f;
-                
-                if (levelDb < kneeStart)
-                    gr = 0.0f;
-                else if (levelDb > kneeEnd)
-                    gr = (threshold - levelDb) + (levelDb - threshold) / ratio;
-                else
-                {
-                    float x = levelDb - kneeStart;
-                    float w = knee;
-                    gr = (x * x) / (2.0f * w * ratio);
-                }
+                float autoGain = inRms / outRms;
+                makeup = juce::Decibels::gainToDecibels(autoGain);
+                makeup = juce::jlimit(-12.0f, 24.0f, makeup);
             }
-            else
+        }
+        
+        // Parallel blend: dry + wet * envelope, with makeup on the compressed copy only.
+        // The dry path is the same lookahead-delayed signal the envelope is applied to, so
+        // it is latency-aligned by construction. Both gains ramp across the block.
+        const float mix = smoothedCompMix.skip(numSamples) * 0.01f;
+        const float dryGain = 1.0f - mix;
+        const float wetGain = mix * juce::Decibels::decibelsToGain(makeup);
+        const float dryStep = (dryGain - compDryGain) / static_cast<float>(numSamples);
+        const float wetStep = (wetGain - compWetGain) / static_cast<float>(numSamples);
+        for (int lane = 0; lane < 2 * numBands; ++lane)
+        {
+            float* gain = gainLanes.getWritePointer(lane);
+            for (int i = 0; i < numSamples; ++i)
             {
-                // Hard knee
-                if (levelDb > threshold)
-                    gr = (threshold - levelDb) + (levelDb - threshold) / ratio;
+                const float t = static_cast<float>(i + 1);
+                gain[i] = (compDryGain + dryStep * t) + (compWetGain + wetStep * t) * gain[i];
             }
-            
-            // Envelope follower
-            float targetGain = juce::Decibels::decibelsToGain(gr);
-            if (targetGain < envelopeState)
-                envelopeState = attackCoeff * envelopeState + (1.0f - attackCoeff) * targetGain;
-            else
-                envelopeState = releaseCoeff * envelopeState + (1.0f - releaseCoeff) * targetGain;
-            
-            // Track input RMS for auto-makeup
-            if (autoMakeupEnabled)
+        }
+        compDryGain = dryGain;
+        compWetGain = wetGain;
+        
+        // Apply gain reduction with lookahead
+        if (!multiband)
+        {
+            if (lookaheadSamples > 0)
+                delayForLookahead(left, right, 0, numSamples, stereo);
+            applyLaneGains(left, right, gainLanes.getReadPointer(0), gainLanes.getReadPointer(1), numSamples, stereo);
+        }
+        else
+        {
+            for (int b = 0; b < numBands; ++b)
             {
-                int amIdx = autoMakeupIndex % autoMakeupWindowSize;
-                autoMakeupBuffer[amIdx] = detectorSample * detectorSample;
-                autoMakeupIndex++;
+                float* bandLeft = bandBuffer.getWritePointer(2 * b);
+                float* bandRight = bandBuffer.getWritePointer(2 * b + 1);
+                if (lookaheadSamples > 0)
+                    delayForLookahead(bandLeft, bandRight, 2 * b, numSamples, true);
+                applyLaneGains(bandLeft, bandRight, gainLanes.getReadPointer(2 * b), gainLanes.getReadPointer(2 * b + 1),
+                               numSamples, true);
             }
             
-            // Apply gain reduction with lookahead
+            // Recombine (the bands sum to an allpass of the input)
             for (int ch = 0; ch < numChannels; ++ch)
             {
-                float sample = buffer.getSample(ch, i);
-                
-                if (lookaheadSamples > 0)
-                {
-                    lookaheadDelay.pushSample(ch, sample);
-                    sample = lookaheadDelay.popSample(ch);
-                }
-                
-                sample *= envelopeState;
-                
-                // Track output RMS for auto-makeup
-                if (autoMakeupEnabled && ch == 0)
-                    outputRms += sample * sample;
-                
-                buffer.setSample(ch, i, sample);
+                float* out = ch == 0 ? left : right;
+                const float* low = bandBuffer.getReadPointer(ch);
+                const float* mid = bandBuffer.getReadPointer(2 + ch);
+                const float* high = bandBuffer.getReadPointer(4 + ch);
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = low[i] + mid[i] + high[i];
             }
-            
-            if (autoMakeupEnabled && i == 0)
-                inputRms = detectorSample * detectorSample;
         }
         
-        // Auto-makeup calculation
-        float makeup = smoothedMakeup.getNextValue();
-        if (autoMakeupEnabled && numSamples > 0)
+        // Store GR for metering
+        gainReduction = juce::Decibels::gainToDecibels(meterGain);
+    }
+
+    // Clipper and true-peak limiter in one 4x section: one FIR round trip instead of two.
+    // The parallel dry mix happens at the high rate too, so it needs no delay compensation.
+    void processSharedClipperLimiter(juce::AudioBuffer<float>& buffer)
+    {
+        const int numSamples = buffer.getNumSamples();
+        
+        const float driveGain = juce::Decibels::decibelsToGain(smoothedClipperDrive.skip(numSamples));
+        const float outputGain = juce::Decibels::decibelsToGain(smoothedClipperOutput.skip(numSamples));
+        const float mix = smoothedClipperMix.skip(numSamples) * 0.01f;
+        
+        const int factor = static_cast<int>(oversampling->getOversamplingFactor());
+        const float ceilingGain = updateLimiter(numSamples, factor);
+        
+        juce::dsp::AudioBlock<float> block(buffer);
+        auto oversampledBlock = oversampling->processSamplesUp(block);
+        const int osNumSamples = static_cast<int>(oversampledBlock.getNumSamples());
+        const size_t numChannels = oversampledBlock.getNumChannels();
+        const bool useAdaa = clipperAdaa.getOrder() != AdaaClipper::Off;
+        const bool delayDry = clipperAdaa.getLatencySamples() > 0;
+        
+        // Clipper and parallel mix, one channel at a time
+        for (size_t ch = 0; ch < numChannels; ++ch)
         {
-            float inRms = 0.0f, outRms = 0.0f;
-            for (int j = 0; j < autoMakeupWindowSize; ++j)
+            float* data = oversampledBlock.getChannelPointer(ch);
+            if (!useAdaa)
             {
-                inRms += autoMakeupBuffer[j];
-                outRms += autoMakeupBuffer[j] * envelopeState * envelopeState;
+                ClipCurves::processBlock(clipperCurve, data, osNumSamples, driveGain, outputGain, mix);
+                continue;
             }
-            inRms = std::sqrt(inRms / autoMakeupWindowSize);
-            outRms = std::sqrt(outRms / autoMakeupWindowSize);
             
-            if (outRms > 1e-6f)
+            for (int i = 0; i < osNumSamples; ++i)
             {
-                float autoGain = inRms / outRms;
-                makeup = juce::Decibels::gainToDecibels(autoGain);
-                makeup = juce::jlimit(-12.0f, 24.0f, makeup);
+                float dry = data[i];
+                const float wet = clipperAdaa.process(static_cast<int>(ch), dry * driveGain) * outputGain;
+                if (delayDry)
+                    std::swap(dry, sharedDryHistory[ch]); // second-order ADAA lags by one sample
+                data[i] = dry + mix * (wet - dry);
             }
         }
         
-        // Apply makeup gain
-        float makeupGain = juce::Decibels::decibelsToGain(makeup);
-        buffer.applyGain(makeupGain);
+        processLimiterBlock(oversampledBlock, osNumSamples);
         
-        // Store GR for metering
-        gainReduction = juce::Decibels::gainToDecibels(envelopeState);
+        oversampling->processSamplesDown(block);
+        clampToCeiling(buffer, ceilingGain);
+    }
+
+    // Drive, curve, output on one channel (fully wet)
+    void processClipperChannel(int channel, float* data, int numSamples, float driveGain, float outputGain, bool useAdaa)
+    {
+        if (!useAdaa)
+        {
+            ClipCurves::processBlock(clipperCurve, data, numSamples, driveGain, outputGain);
+            return;
+        }
+        
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = clipperAdaa.process(channel, data[i] * driveGain) * outputGain;
     }
 
     void processClipper(juce::AudioBuffer<float>& buffer)
@@ -284,56 +741,43 @@ private:
         const int numSamples = buffer.getNumSamples();
         const int numChannels = buffer.getNumChannels();
         
-        float driveDb = smoothedClipperDrive.getNextValue();
-        float outputDb = smoothedClipperOutput.getNextValue();
-        float mix = smoothedClipperMix.getNextValue() * 0.01f; // 0-100% to 0-1
+        // Smoothers advance by the whole block (one step per block would take seconds to settle)
+        float driveDb = smoothedClipperDrive.skip(numSamples);
+        float outputDb = smoothedClipperOutput.skip(numSamples);
+        float mix = smoothedClipperMix.skip(numSamples) * 0.01f; // 0-100% to 0-1
         
         float driveGain = juce::Decibels::decibelsToGain(driveDb);
         float outputGain = juce::Decibels::decibelsToGain(outputDb);
+        const bool useAdaa = clipperAdaa.getOrder() != AdaaClipper::Off;
         
-        // Store dry signal for parallel mix
-        juce::AudioBuffer<float> dryBuffer(numChannels, numSamples);
+        // Store dry signal for parallel mix, delayed by the oversampler (or, at 1x, the ADAA) latency
+        const int dryDelay = clipperOversamplingFactor > 0 ? getOversamplerLatency(getClipperOversampler())
+                                                           : clipperAdaa.getLatencySamples();
+        dryBuffer.setSize(numChannels, numSamples, false, false, true);
         for (int ch = 0; ch < numChannels; ++ch)
-            dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-        
-        auto processClipCurve = [this](float sample) -> float
         {
-            switch (clipperCurve)
+            const auto* in = buffer.getReadPointer(ch);
+            auto* dry = dryBuffer.getWritePointer(ch);
+            for (int i = 0; i < numSamples; ++i)
             {
-                case 0: // tanh (smooth)
-                    return std::tanh(sample);
-                case 1: // atan (harder)
-                    return (2.0f / juce::MathConstants<float>::pi) * std::atan(sample * 1.5f);
-                case 2: // polynomial (x - x^3/3)
-                {
-                    float x = juce::jlimit(-1.5f, 1.5f, sample);
-                    return x - (x * x * x) / 3.0f;
-                }
-                default:
-                    return std::tanh(sample);
+                // Always pushed so the line stays primed when the mix or OS setting changes
+                clipperDryDelay.pushSample(ch, in[i]);
+                dry[i] = clipperDryDelay.popSample(ch, static_cast<float>(dryDelay));
             }
-        };
+        }
         
         if (clipperOversamplingFactor > 0)
         {
             // Apply oversampling
             juce::dsp::AudioBlock<float> block(buffer);
-            auto* os = (clipperOversamplingFactor == 1) ? clipperOversampling2x.get() : clipperOversampling4x.get();
+            auto* os = getClipperOversampler();
             
             auto oversampledBlock = os->processSamplesUp(block);
             const int osNumSamples = static_cast<int>(oversampledBlock.getNumSamples());
             
-            for (int i = 0; i < osNumSamples; ++i)
-            {
-                for (size_t ch = 0; ch < oversampledBlock.getNumChannels(); ++ch)
-                {
-                    float sample = oversampledBlock.getSample(ch, i);
-                    sample *= driveGain;
-                    sample = processClipCurve(sample);
-                    sample *= outputGain;
-                    oversampledBlock.setSample(ch, i, sample);
-                }
-            }
+            for (size_t ch = 0; ch < oversampledBlock.getNumChannels(); ++ch)
+                processClipperChannel(static_cast<int>(ch), oversampledBlock.getChannelPointer(ch), osNumSamples,
+                                      driveGain, outputGain, useAdaa);
             
             os->processSamplesDown(block);
         }
@@ -341,17 +785,7 @@ private:
         {
             // No oversampling
             for (int ch = 0; ch < numChannels; ++ch)
-            {
-                auto* data = buffer.getWritePointer(ch);
-                for (int i = 0; i < numSamples; ++i)
-                {
-                    float sample = data[i];
-                    sample *= driveGain;
-                    sample = processClipCurve(sample);
-                    sample *= outputGain;
-                    data[i] = sample;
-                }
-            }
+                processClipperChannel(ch, buffer.getWritePointer(ch), numSamples, driveGain, outputGain, useAdaa);
         }
         
         // Parallel mix
@@ -367,126 +801,96 @@ private:
         }
     }
 
+    int getLimiterLookaheadSamples() const
+    {
+        return static_cast<int>(spec.sampleRate * limiterLookaheadMs * 0.001f);
+    }
+
+    // Advances the limiter smoothers by a block and sets up the limiter to run at
+    // rateFactor x the host rate; returns the ceiling gain
+    float updateLimiter(int numSamples, int rateFactor)
+    {
+        const float ceilingGain = juce::Decibels::decibelsToGain(smoothedLimiterCeiling.skip(numSamples));
+        const float knee = smoothedLimiterKnee.skip(numSamples);
+        const float releaseMs = smoothedLimiterRelease.skip(numSamples);
+        const double rate = spec.sampleRate * rateFactor;
+        
+        // Inter-sample peaks are estimated on the detector path when not oversampling
+        limiter.setLookahead(getLimiterLookaheadSamples() * rateFactor, rateFactor == 1);
+        limiter.setParameters(ceilingGain, knee, static_cast<float>(std::exp(-1.0 / (releaseMs * 0.001 * rate))));
+        return ceilingGain;
+    }
+
+    void processLimiterBlock(juce::dsp::AudioBlock<float>& block, int numSamples)
+    {
+        std::array<float*, LookaheadLimiter::MAX_CHANNELS> channels{};
+        const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), LookaheadLimiter::MAX_CHANNELS);
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[static_cast<size_t>(ch)] = block.getChannelPointer(static_cast<size_t>(ch));
+        limiter.process(channels.data(), numChannels, numSamples);
+    }
+
+    // The downsampling filter can ring slightly past a brickwalled high-rate signal
+    static void clampToCeiling(juce::AudioBuffer<float>& buffer, float ceilingGain)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::clip(buffer.getWritePointer(ch), buffer.getReadPointer(ch),
+                                              -ceilingGain, ceilingGain, buffer.getNumSamples());
+    }
+
     void processTruePeakLimiter(juce::AudioBuffer<float>& buffer)
     {
         const int numSamples = buffer.getNumSamples();
-        const int numChannels = buffer.getNumChannels();
-        
-        float ceiling = smoothedLimiterCeiling.getNextValue();
-        float knee = smoothedLimiterKnee.getNextValue();
-        float releaseMs = smoothedLimiterRelease.getNextValue();
-        
-        int lookaheadSamples = static_cast<int>(spec.sampleRate * limiterLookaheadMs * 0.001f);
-        limiterLookahead.setDelay(static_cast<float>(lookaheadSamples));
-        
-        float releaseCoeff = std::exp(-1.0f / (releaseMs * 0.001f * spec.sampleRate));
-        float ceilingGain = juce::Decibels::decibelsToGain(ceiling);
+        juce::dsp::AudioBlock<float> block(buffer);
         
         if (limiterOversamplingEnabled && oversampling)
         {
-            // True-peak detection via 4x oversampling
-            juce::dsp::AudioBlock<float> block(buffer);
+            // True-peak limiting at 4x; lookahead and release run at the oversampled rate
+            const float ceilingGain = updateLimiter(numSamples, static_cast<int>(oversampling->getOversamplingFactor()));
             auto oversampledBlock = oversampling->processSamplesUp(block);
-            
-            const int osNumSamples = static_cast<int>(oversampledBlock.getNumSamples());
-            
-            for (int i = 0; i < osNumSamples; ++i)
-            {
-                float peak = 0.0f;
-                for (size_t ch = 0; ch < oversampledBlock.getNumChannels(); ++ch)
-                    peak = std::max(peak, std::abs(oversampledBlock.getSample(ch, i)));
-                
-                // Gain computer with soft knee
-                float targetGain = 1.0f;
-                if (peak > ceilingGain)
-                {
-                    if (knee > 0.01f)
-                    {
-                        float kneeStart = ceilingGain * (1.0f - knee * 0.1f);
-                        if (peak > kneeStart)
-                        {
-                            float excess = (peak - kneeStart) / (ceilingGain - kneeStart);
-                            targetGain = kneeStart / peak + (1.0f - excess) * (ceilingGain - kneeStart) / peak;
-                        }
-                    }
-                    else
-                    {
-                        targetGain = ceilingGain / peak;
-                    }
-                }
-                
-                // Instant attack, smooth release
-                if (targetGain < limiterEnvelope)
-                    limiterEnvelope = targetGain;
-                else
-                    limiterEnvelope = releaseCoeff * limiterEnvelope + (1.0f - releaseCoeff) * targetGain;
-                
-                // Apply gain
-                for (size_t ch = 0; ch < oversampledBlock.getNumChannels(); ++ch)
-                    oversampledBlock.setSample(ch, i, oversampledBlock.getSample(ch, i) * limiterEnvelope);
-            }
-            
+            processLimiterBlock(oversampledBlock, static_cast<int>(oversampledBlock.getNumSamples()));
             oversampling->processSamplesDown(block);
+            clampToCeiling(buffer, ceilingGain);
         }
         else
         {
-            // Standard peak limiting (no oversampling)
-            for (int i = 0; i < numSamples; ++i)
-            {
-                float peak = 0.0f;
-                for (int ch = 0; ch < numChannels; ++ch)
-                {
-                    float sample = buffer.getSample(ch, i);
-                    if (lookaheadSamples > 0)
-                    {
-                        limiterLookahead.pushSample(ch, sample);
-                        sample = limiterLookahead.popSample(ch);
-                    }
-                    peak = std::max(peak, std::abs(sample));
-                }
-                
-                float targetGain = 1.0f;
-                if (peak > ceilingGain)
-                    targetGain = ceilingGain / peak;
-                
-                if (targetGain < limiterEnvelope)
-                    limiterEnvelope = targetGain;
-                else
-                    limiterEnvelope = releaseCoeff * limiterEnvelope + (1.0f - releaseCoeff) * targetGain;
-                
-                for (int ch = 0; ch < numChannels; ++ch)
-                {
-                    float sample = buffer.getSample(ch, i);
-                    if (lookaheadSamples > 0)
-                    {
-                        limiterLookahead.pushSample(ch, sample);
-                        sample = limiterLookahead.popSample(ch);
-                    }
-                    buffer.setSample(ch, i, sample * limiterEnvelope);
-                }
-            }
+            updateLimiter(numSamples, 1);
+            processLimiterBlock(block, numSamples);
         }
     }
 
     juce::dsp::ProcessSpec spec;
+    int maxBlock = 512;
     juce::dsp::DelayLine<float> lookaheadDelay{1024};
-    juce::dsp::DelayLine<float> limiterLookahead{2048};
-    juce::dsp::IIR::Filter<float> scHpf;
+    LookaheadLimiter limiter;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> clipperDryDelay{256};
+    juce::AudioBuffer<float> dryBuffer;
+    std::array<CompressorBand, ThreeBandCrossover::NUM_BANDS> compBands;
+    ThreeBandCrossover crossover;
+    juce::AudioBuffer<float> bandBuffer; // crossover outputs, L/R per band
+    juce::AudioBuffer<float> gainLanes;  // compressor scratch: detector signal -> level -> gain, two lanes per band
     std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
     std::unique_ptr<juce::dsp::Oversampling<float>> clipperOversampling2x;
     std::unique_ptr<juce::dsp::Oversampling<float>> clipperOversampling4x;
     
-    juce::SmoothedValue<float> smoothedThreshold, smoothedRatio, smoothedAttack, smoothedRelease;
-    juce::SmoothedValue<float> smoothedKnee, smoothedMakeup, smoothedScHpf;
-    juce::SmoothedValue<float> smoothedLimiterCeiling, smoothedLimiterRelease, smoothedLimiterKnee;
-    juce::SmoothedValue<float> smoothedClipperDrive, smoothedClipperOutput, smoothedClipperMix;
+    // Start from the parameter defaults so the first block doesn't ramp up from zero (ratio 0 is undefined)
+    juce::SmoothedValue<float> smoothedThreshold{-12.0f}, smoothedRatio{4.0f}, smoothedAttack{10.0f}, smoothedRelease{100.0f};
+    juce::SmoothedValue<float> smoothedKnee{6.0f}, smoothedMakeup{0.0f}, smoothedScHpf{80.0f}, smoothedCompMix{100.0f};
+    juce::SmoothedValue<float> smoothedCrossoverLow{150.0f}, smoothedCrossoverHigh{4000.0f};
+    juce::SmoothedValue<float> smoothedLimiterCeiling{-0.3f}, smoothedLimiterRelease{50.0f}, smoothedLimiterKnee{0.5f};
+    juce::SmoothedValue<float> smoothedClipperDrive{0.0f}, smoothedClipperOutput{0.0f}, smoothedClipperMix{100.0f};
     
-    std::vector<float> rmsBuffer, autoMakeupBuffer;
-    int rmsWindowSize = 0, rmsIndex = 0;
-    int autoMakeupWindowSize = 0, autoMakeupIndex = 0;
+    RmsDetector autoMakeupDetector;
+    float autoMakeupMeanSquare = 0.0f;
     
-    float gainReduction = 0.0f, envelopeState = 0.0f, limiterEnvelope = 1.0f;
+    float gainReduction = 0.0f;
+    std::array<float, ThreeBandCrossover::NUM_BANDS> bandGainReduction{};
+    float compDryGain = 0.0f, compWetGain = 1.0f;     // parallel blend at the end of the last block
     float currentScHpf = 80.0f, lookaheadMs = 0.0f, limiterLookaheadMs = 5.0f;
     bool rmsMode = true, autoMakeupEnabled = false, limiterOversamplingEnabled = true;
+    int linkMode = MonoSum, bandMode = SingleBand;
+    bool multibandActive = false;
     int clipperCurve = 0, clipperOversamplingFactor = 2; // 0=off, 1=2x, 2=4x
+    AdaaClipper clipperAdaa;
+    std::array<float, 2> sharedDryHistory{};
 };
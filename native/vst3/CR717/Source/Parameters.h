@@ -127,6 +127,17 @@ namespace ParamIDs
     inline constexpr auto delayModRate = "delayModRate";
     inline constexpr auto delayModDepth = "delayModDepth";
     
+    // Send FX rate reduction (reverb + delay)
+    inline constexpr auto fxEcoMode = "fxEcoMode";
+    
+    // Sequencer
+    inline constexpr auto seqHumanize = "seqHumanize";
+    
+    // FX graph routing
+    inline constexpr auto fxSendRouting = "fxSendRouting";
+    inline constexpr auto masterChainOrder = "masterChainOrder";
+    inline constexpr auto fxReturnPoint = "fxReturnPoint";
+    
     // Master Dynamics
     inline constexpr auto compThreshold = "compThreshold";
     inline constexpr auto compRatio = "compRatio";
@@ -137,7 +148,16 @@ namespace ParamIDs
     inline constexpr auto compAutoMakeup = "compAutoMakeup";
     inline constexpr auto compScHpf = "compScHpf";
     inline constexpr auto compDetector = "compDetector";
+    inline constexpr auto compRmsType = "compRmsType";
     inline constexpr auto compLookahead = "compLookahead";
+    inline constexpr auto compLink = "compLink";
+    inline constexpr auto compMix = "compMix";
+    inline constexpr auto compBands = "compBands";
+    inline constexpr auto compXoverLow = "compXoverLow";
+    inline constexpr auto compXoverHigh = "compXoverHigh";
+    inline constexpr auto compLowThreshold = "compLowThreshold";
+    inline constexpr auto compMidThreshold = "compMidThreshold";
+    inline constexpr auto compHighThreshold = "compHighThreshold";
     inline constexpr auto compEnabled = "compEnabled";
     inline constexpr auto limiterCeiling = "limiterCeiling";
     inline constexpr auto limiterRelease = "limiterRelease";
@@ -150,7 +170,28 @@ namespace ParamIDs
     inline constexpr auto clipperMix = "clipperMix";
     inline constexpr auto clipperCurve = "clipperCurve";
     inline constexpr auto clipperOversampling = "clipperOversampling";
+    inline constexpr auto clipperAntialias = "clipperAntialias";
     inline constexpr auto clipperEnabled = "clipperEnabled";
+    
+    // Trigger-keyed ducking
+    inline constexpr auto duckEnabled = "duckEnabled";
+    inline constexpr auto duckSource = "duckSource";
+    inline constexpr auto duckDepth = "duckDepth";
+    inline constexpr auto duckAttack = "duckAttack";
+    inline constexpr auto duckRelease = "duckRelease";
+    inline constexpr auto duckReverb = "duckReverb";
+    inline constexpr auto duckDelay = "duckDelay";
+    inline constexpr auto duckVoices = "duckVoices";
+    
+    // Per-voice insert slots, e.g. "bdIns1Type", "bdIns1A" (voice order matches the sequencer rows)
+    inline constexpr int numInsertSlots = 2;
+    inline constexpr const char* voicePrefixes[] = {"bd", "sd", "lt", "mt", "ht", "rs",
+                                                     "cp", "ch", "oh", "cy", "rd", "cb"};
+    
+    inline juce::String insertParam(int voice, int slot, const char* field)
+    {
+        return juce::String(voicePrefixes[voice]) + "Ins" + juce::String(slot + 1) + field;
+    }
 }
 
 inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
@@ -281,6 +322,17 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::delayModRate, 1}, "Delay Mod Rate", juce::NormalisableRange<float>(0.1f, 5.0f), 0.0f));
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::delayModDepth, 1}, "Delay Mod Depth", juce::NormalisableRange<float>(0.0f, 10.0f), 0.0f));
     
+    // Send FX rate reduction: only engages while the reduced rate stays >= 44.1 kHz
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::fxEcoMode, 1}, "FX Eco Mode", juce::StringArray{"Off", "1/2 Rate", "1/4 Rate"}, 0));
+    
+    // Share of the preset genre's timing and velocity humanisation that plays; off by default
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::seqHumanize, 1}, "Humanize", juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
+    
+    // FX graph routing (see FxRouting in FxGraph.h)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::fxSendRouting, 1}, "FX Send Routing", juce::StringArray{"Parallel", "Reverb > Delay", "Delay > Reverb"}, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::masterChainOrder, 1}, "Master Chain Order", juce::StringArray{"Comp > Clip > Limit", "Clip > Comp > Limit"}, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::fxReturnPoint, 1}, "FX Return Point", juce::StringArray{"Pre Dynamics", "Post Compressor"}, 0));
+    
     // Master Dynamics
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compThreshold, 1}, "Comp Threshold", juce::NormalisableRange<float>(-40.0f, 0.0f), -12.0f));
     layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::compRatio, 1}, "Comp Ratio", juce::StringArray{"1:1", "2:1", "4:1", "8:1", "10:1", "20:1", "∞:1"}, 2));
@@ -291,7 +343,16 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
     layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::compAutoMakeup, 1}, "Comp Auto Makeup", false));
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compScHpf, 1}, "Comp SC HPF", juce::NormalisableRange<float>(20.0f, 500.0f, 0.0f, 0.3f), 80.0f));
     layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::compDetector, 1}, "Comp RMS Mode", true));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::compRmsType, 1}, "Comp RMS Type", juce::StringArray{"Window", "Smooth"}, 0));
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compLookahead, 1}, "Comp Lookahead", juce::NormalisableRange<float>(0.0f, 5.0f), 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::compLink, 1}, "Comp Stereo Link", juce::StringArray{"Mono Sum", "Max Linked", "Unlinked", "Mid/Side"}, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compMix, 1}, "Comp Mix", juce::NormalisableRange<float>(0.0f, 100.0f), 100.0f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::compBands, 1}, "Comp Bands", juce::StringArray{"Single", "3-Band"}, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compXoverLow, 1}, "Comp Crossover Low", juce::NormalisableRange<float>(40.0f, 500.0f, 0.0f, 0.4f), 150.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compXoverHigh, 1}, "Comp Crossover High", juce::NormalisableRange<float>(1000.0f, 12000.0f, 0.0f, 0.4f), 4000.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compLowThreshold, 1}, "Comp Low Thresh Offset", juce::NormalisableRange<float>(-24.0f, 24.0f), 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compMidThreshold, 1}, "Comp Mid Thresh Offset", juce::NormalisableRange<float>(-24.0f, 24.0f), 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::compHighThreshold, 1}, "Comp High Thresh Offset", juce::NormalisableRange<float>(-24.0f, 24.0f), 0.0f));
     layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::compEnabled, 1}, "Comp Enabled", true));
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::limiterCeiling, 1}, "Limiter Ceiling", juce::NormalisableRange<float>(-0.3f, 0.0f), -0.3f));
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::limiterRelease, 1}, "Limiter Release", juce::NormalisableRange<float>(10.0f, 1000.0f, 0.0f, 0.3f), 50.0f));
@@ -304,7 +365,32 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::clipperMix, 1}, "Clipper Mix", juce::NormalisableRange<float>(0.0f, 100.0f), 100.0f));
     layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::clipperCurve, 1}, "Clipper Curve", juce::StringArray{"Tanh", "Atan", "Poly"}, 0));
     layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::clipperOversampling, 1}, "Clipper OS", juce::StringArray{"Off", "2x", "4x"}, 2));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::clipperAntialias, 1}, "Clipper Antialias", juce::StringArray{"Off", "ADAA 1st", "ADAA 2nd"}, 0));
     layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::clipperEnabled, 1}, "Clipper Enabled", false));
     
+    // Trigger-keyed ducking
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::duckEnabled, 1}, "Duck Enabled", false));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::duckSource, 1}, "Duck Source", juce::StringArray{"BD", "SD", "LT", "MT", "HT", "RS", "CP", "CH", "OH", "CY", "RD", "CB"}, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::duckDepth, 1}, "Duck Depth", juce::NormalisableRange<float>(-48.0f, 0.0f), -12.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::duckAttack, 1}, "Duck Attack", juce::NormalisableRange<float>(0.1f, 50.0f, 0.0f, 0.3f), 2.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::duckRelease, 1}, "Duck Release", juce::NormalisableRange<float>(10.0f, 1000.0f, 0.0f, 0.3f), 150.0f));
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::duckReverb, 1}, "Duck Reverb", true));
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::duckDelay, 1}, "Duck Delay", true));
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ParamIDs::duckVoices, 1}, "Duck Voices", false));
+    
+    // Insert FX (2 slots per voice; A/B/C meaning depends on the slot type, see VoiceInserts.h)
+    for (int v = 0; v < 12; ++v)
+    {
+        const auto voiceName = juce::String(ParamIDs::voicePrefixes[v]).toUpperCase();
+        for (int s = 0; s < ParamIDs::numInsertSlots; ++s)
+        {
+            const auto slotName = voiceName + " Insert " + juce::String(s + 1);
+            layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ParamIDs::insertParam(v, s, "Type"), 1}, slotName + " Type", juce::StringArray{"Off", "Drive", "EQ", "Transient", "Bitcrusher"}, 0));
+            layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::insertParam(v, s, "A"), 1}, slotName + " A", juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
+            layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::insertParam(v, s, "B"), 1}, slotName + " B", juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
+            layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ParamIDs::insertParam(v, s, "C"), 1}, slotName + " C", juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
+        }
+    }
+    
     return layout;
 }
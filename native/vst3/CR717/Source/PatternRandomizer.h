@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include "StepMask.h"
 #include <random>
 #include <array>
 
@@ -22,7 +23,13 @@ public:
     
     std::array<bool, 16> generatePattern(const juce::String& voice, const juce::String& genre, float amount = 0.5f)
     {
-        std::array<bool, 16> pattern{};
+        return StepMask::toArray<16>(generateSteps(voice, genre, amount));
+    }
+    
+    // Same as generatePattern, as a step mask for Sequencer::Pattern::setSteps()/merge()
+    uint64_t generateSteps(const juce::String& voice, const juce::String& genre, float amount = 0.5f)
+    {
+        uint64_t steps = 0;
         const auto& config = getGenreConfig(genre);
         
         float density = config.voiceDensity.count(voice) ? config.voiceDensity.at(voice) : 0.3f;
@@ -35,16 +42,16 @@ public:
         {
             for (int step : config.allowedSteps.at(voice))
                 if (step < 16 && dist(rng) < density)
-                    pattern[step] = true;
+                    steps |= uint64_t{1} << step;
         }
         else
         {
             for (int i = 0; i < 16; ++i)
                 if (dist(rng) < density)
-                    pattern[i] = true;
+                    steps |= uint64_t{1} << i;
         }
         
-        return pattern;
+        return steps;
     }
     
     static GenreConfig getGenreConfig(const juce::String& genre)
@@ -15,7 +15,8 @@ public:
         filter.setCoefficients(juce::IIRCoefficients::makeBandPass(sr, 1500.0));
     }
 
-    void trigger(float velocity) override
+    // The pulse train runs on whole samples
+    void trigger(float velocity, float = 0.0f) override
     {
         env = velocity;
         pulseIndex = 0;
@@ -89,12 +90,13 @@ public:
         filter.setCoefficients(juce::IIRCoefficients::makeBandPass(sr, 2500.0));
     }
 
-    void trigger(float velocity) override
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        phase = 0.0f;
-        env = velocity;
-        active = true;
         updateSmoothedValues();
+        const float elapsed = fraction / static_cast<float>(sampleRate);
+        phase = frequency(tune.getCurrentValue()) * elapsed;
+        env = velocity * std::exp(-elapsed / DECAY_TIME);
+        active = true;
     }
 
     bool isActive() const override { return active && env > 0.0001f; }
@@ -112,7 +114,7 @@ public:
             }
 
             // Metallic tone
-            float freq = (540.0f + tune.getNextValue() * 100.0f) / static_cast<float>(sampleRate);
+            float freq = frequency(tune.getNextValue()) / static_cast<float>(sampleRate);
             float tone = std::sin(phase * juce::MathConstants<float>::twoPi);
             phase += freq;
             if (phase >= 1.0f) phase -= 1.0f;
@@ -123,15 +125,20 @@ public:
 
             float sample = (tone * 0.3f + noise * 0.7f) * env * level.getNextValue();
             
-            // TR-808 spec: Expo decay ~30ms
-            float decayRate = std::exp(-1.0f / (0.03f * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate();
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // Metallic tone
+    static float frequency(float tuneVal) { return 540.0f + tuneVal * 100.0f; }
+
+    // TR-808 spec: Expo decay ~30ms
+    static constexpr float DECAY_TIME = 0.03f;
+    float decayRate() const { return std::exp(-1.0f / (DECAY_TIME * static_cast<float>(sampleRate))); }
+
     float phase = 0.0f;
     float env = 0.0f;
     bool active = false;
@@ -34,10 +34,18 @@ CR717Editor::CR717Editor(CR717Processor& p)
     {
         handlePresetChange(index);
     };
-    header->onPatternChange = [this](int bank)
+    header->onPatternChange = [this](int slot)
     {
-        // Map A-H to first 8 presets for now (pattern banks)
-        handlePresetChange(bank);
+        // A-H are the first 8 bank slots: edit the slot and play it from the next bar
+        auto& seq = processor.getSequencer();
+        seq.setEditSlot(slot);
+        seq.selectPattern(slot);
+        loadPatternFromProcessor();
+    };
+    header->onRandomize = [this]
+    {
+        processor.randomizePattern();
+        loadPatternFromProcessor();
     };
     addAndMakeVisible(header.get());
 
@@ -100,6 +108,7 @@ CR717Editor::CR717Editor(CR717Processor& p)
     // Master panel
     masterPanel = std::make_unique<MasterPanel>();
     addAndMakeVisible(masterPanel.get());
+    masterPanel->getLoudnessDisplay().onReset = [this] { processor.resetLoudness(); };
 
     // Attach master + FX params
     masterPanel->getOutputGain().setRange(0.0, 1.0, 0.001);
@@ -168,20 +177,49 @@ void CR717Editor::timerCallback()
 
 void CR717Editor::updatePlayhead()
 {
-    auto& seq = processor.getSequencer();
-    sequencer->setPlaying(seq.getPlaying());
-    if (seq.getPlaying())
-        sequencer->setCurrentStep(seq.getCurrentStep());
+    // Only the newest report matters for the playhead
+    Sequencer::Position position;
+    bool received = false;
+    while (processor.getSequencer().popPosition(position))
+        received = true;
+    
+    if (received)
+    {
+        sequencer->setPlaying(position.playing);
+        if (position.playing)
+            sequencer->setCurrentStep(position.step);
+    }
 }
 
 void CR717Editor::updateMeters()
 {
-    auto& meters = masterPanel->getMeters();
-    meters.setPeakLevel(0, processor.getPeakLevel(0));
-    meters.setPeakLevel(1, processor.getPeakLevel(1));
-    meters.setRMSLevel(0, processor.getRMSLevel(0));
-    meters.setRMSLevel(1, processor.getRMSLevel(1));
-    masterPanel->setClipping(processor.isClipping());
+    // Drain every frame since the last tick so no peak between repaints is missed
+    LoudnessMeter::Frame frame, latest;
+    float peak[2] = {0.0f, 0.0f};
+    bool received = false;
+    while (processor.popMeterFrame(frame))
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            peak[ch] = juce::jmax(peak[ch], frame.peak[static_cast<size_t>(ch)]);
+        latest = frame;
+        received = true;
+    }
+    
+    if (received)
+    {
+        auto& meters = masterPanel->getMeters();
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            meters.setPeakLevel(ch, peak[ch]);
+            meters.setRMSLevel(ch, latest.rms[static_cast<size_t>(ch)]);
+        }
+        masterPanel->setClipping(peak[0] > 0.999f || peak[1] > 0.999f);
+        masterPanel->getLoudnessDisplay().setValues(latest.momentary, latest.shortTerm, latest.integrated,
+                                                    latest.range, latest.maxTruePeak);
+    }
+    
+    for (int band = 0; band < 3; ++band)
+        masterPanel->getGainReductionMeter().setGainReduction(band, processor.getCompressorGainReduction(band));
 }
 
 void CR717Editor::loadPatternFromProcessor()
@@ -203,9 +241,7 @@ void CR717Editor::savePadToProcessor(int step, int voice, StepPad::State state)
 {
     bool active = (state != StepPad::State::Off);
     bool accent = (state == StepPad::State::Accent);
-    auto& seq = processor.getSequencer();
-    seq.setStep(voice, step, active);
-    seq.setAccent(voice, step, accent);
+    processor.getSequencer().setStep(voice, step, active, accent);
 }
 
 void CR717Editor::handlePresetChange(int index)
@@ -7,41 +7,182 @@
 CR717Processor::CR717Processor()
     : AudioProcessor(BusesProperties()
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      apvts(*this, nullptr, "Parameters", createParameterLayout())
+      apvts(*this, nullptr, "Parameters", createParameterLayout()),
+      voices{&bassDrum, &snareDrum, &lowTom, &midTom, &highTom, &rimShot,
+             &clap, &closedHat, &openHat, &cymbal, &ride, &cowbell}
 {
+    for (int v = 0; v < Sequencer::NUM_VOICES; ++v)
+    {
+        for (int s = 0; s < ParamIDs::numInsertSlots; ++s)
+        {
+            auto& p = insertParams[v][s];
+            p.type = apvts.getRawParameterValue(ParamIDs::insertParam(v, s, "Type"));
+            p.a = apvts.getRawParameterValue(ParamIDs::insertParam(v, s, "A"));
+            p.b = apvts.getRawParameterValue(ParamIDs::insertParam(v, s, "B"));
+            p.c = apvts.getRawParameterValue(ParamIDs::insertParam(v, s, "C"));
+        }
+    }
+    
+    // FX graph nodes (the graph decides the order and which bus each one sees)
+    fxGraph.setNode(FxGraph::ReverbNode, [this](juce::AudioBuffer<float>& bus, int numSamples)
+    {
+        if (sendEcoFactor > 1)
+        {
+            const int lowSamples = reverbResampler.down(bus, numSamples);
+            reverb.process(reverbResampler.getLowBuffer(), lowSamples);
+            reverbResampler.up(bus, numSamples);
+        }
+        else
+        {
+            reverb.process(bus, numSamples);
+        }
+    });
+    fxGraph.setNode(FxGraph::DelayNode, [this](juce::AudioBuffer<float>& bus, int numSamples)
+    {
+        if (sendEcoFactor > 1)
+        {
+            const int lowSamples = delayResampler.down(bus, numSamples);
+            delay.process(delayResampler.getLowBuffer(), lowSamples);
+            delayResampler.up(bus, numSamples);
+        }
+        else
+        {
+            delay.process(bus, numSamples);
+        }
+    });
+    fxGraph.setNode(FxGraph::DuckReverbNode, [this](juce::AudioBuffer<float>& bus, int numSamples)
+    {
+        if (duckReverbActive)
+            ducker.apply(bus, numSamples);
+    });
+    fxGraph.setNode(FxGraph::DuckDelayNode, [this](juce::AudioBuffer<float>& bus, int numSamples)
+    {
+        if (duckDelayActive)
+            ducker.apply(bus, numSamples);
+    });
+    fxGraph.setNode(FxGraph::CompressorNode, [this](juce::AudioBuffer<float>& bus, int)
+    {
+        if (compEnabled)
+            masterDynamics.processStage(MasterDynamics::Stage::Compressor, bus);
+    });
+    fxGraph.setNode(FxGraph::ClipperNode, [this](juce::AudioBuffer<float>& bus, int)
+    {
+        if (clipperEnabled)
+            masterDynamics.processStage(MasterDynamics::Stage::Clipper, bus);
+    });
+    fxGraph.setNode(FxGraph::LimiterNode, [this](juce::AudioBuffer<float>& bus, int)
+    {
+        if (limiterEnabled)
+            masterDynamics.processStage(MasterDynamics::Stage::Limiter, bus);
+    });
+    fxGraph.setNode(FxGraph::ClipLimitNode, [this](juce::AudioBuffer<float>& bus, int)
+    {
+        if (clipperEnabled && limiterEnabled)
+            masterDynamics.processStage(MasterDynamics::Stage::ClipperAndLimiter, bus);
+        else if (clipperEnabled)
+            masterDynamics.processStage(MasterDynamics::Stage::Clipper, bus);
+        else if (limiterEnabled)
+            masterDynamics.processStage(MasterDynamics::Stage::Limiter, bus);
+    });
 }
 
 void CR717Processor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    setLatencySamples(0);
-    
-    bassDrum.prepare(sampleRate, samplesPerBlock);
-    snareDrum.prepare(sampleRate, samplesPerBlock);
-    lowTom.prepare(sampleRate, samplesPerBlock);
-    midTom.prepare(sampleRate, samplesPerBlock);
-    highTom.prepare(sampleRate, samplesPerBlock);
-    rimShot.prepare(sampleRate, samplesPerBlock);
-    clap.prepare(sampleRate, samplesPerBlock);
-    closedHat.prepare(sampleRate, samplesPerBlock);
-    openHat.prepare(sampleRate, samplesPerBlock);
-    cymbal.prepare(sampleRate, samplesPerBlock);
-    ride.prepare(sampleRate, samplesPerBlock);
-    cowbell.prepare(sampleRate, samplesPerBlock);
+    for (auto* voice : voices)
+    {
+        voice->prepare(sampleRate, samplesPerBlock);
+        voice->prepareInserts(sampleRate, samplesPerBlock);
+    }
     
     // FX
-    reverb.prepare(sampleRate, samplesPerBlock);
-    delay.prepare(sampleRate, samplesPerBlock);
+    prepareSendFX(sampleRate, samplesPerBlock);
     masterDynamics.prepare(sampleRate, samplesPerBlock);
+    ducker.prepare(sampleRate, samplesPerBlock);
+    outputMeter.prepare(sampleRate, samplesPerBlock);
+    sequencer.prepare(sampleRate);
     
     reverbBuffer.setSize(2, samplesPerBlock);
     delayBuffer.setSize(2, samplesPerBlock);
     voiceBuffer.setSize(2, samplesPerBlock);
+    fxGraph.prepare(reverbBuffer, delayBuffer, samplesPerBlock, masterDynamics.getMaxPreLimiterLatencySamples());
+    publishRouting();
+    
+    // Report the master chain latency for the current settings; processBlock tracks later changes
+    updateFXParameters();
+    masterLatency = computeMasterLatency();
+    setLatencySamples(masterLatency);
 }
 
 void CR717Processor::releaseResources()
 {
 }
 
+int CR717Processor::getRequestedEcoFactor(double sampleRate) const
+{
+    const int choice = static_cast<int>(apvts.getRawParameterValue(ParamIDs::fxEcoMode)->load());
+    int factor = choice == 2 ? 4 : (choice == 1 ? 2 : 1);
+    
+    // Never run the sends below 44.1 kHz; at 48k and below eco mode is a no-op
+    while (factor > 1 && sampleRate / factor < 44100.0 - 1.0)
+        factor /= 2;
+    
+    return factor;
+}
+
+void CR717Processor::prepareSendFX(double sampleRate, int samplesPerBlock)
+{
+    sendEcoFactor = getRequestedEcoFactor(sampleRate);
+    
+    const int fxBlockSize = sendEcoFactor > 1 ? SendResampler::getMaxLowBlockSize(samplesPerBlock) : samplesPerBlock;
+    reverb.prepare(sampleRate / sendEcoFactor, fxBlockSize);
+    delay.prepare(sampleRate / sendEcoFactor, fxBlockSize);
+    reverbResampler.prepare(samplesPerBlock, sendEcoFactor);
+    delayResampler.prepare(samplesPerBlock, sendEcoFactor);
+}
+
+int CR717Processor::computeMasterLatency() const
+{
+    return masterDynamics.getLatencySamples(apvts.getRawParameterValue(ParamIDs::compEnabled)->load() > 0.5f,
+                                            apvts.getRawParameterValue(ParamIDs::limiterEnabled)->load() > 0.5f,
+                                            apvts.getRawParameterValue(ParamIDs::clipperEnabled)->load() > 0.5f,
+                                            getRequestedRouting().clipperFeedsLimiter());
+}
+
+FxRouting CR717Processor::getRequestedRouting() const
+{
+    FxRouting routing;
+    routing.sendChain = static_cast<int>(apvts.getRawParameterValue(ParamIDs::fxSendRouting)->load());
+    routing.masterOrder = static_cast<int>(apvts.getRawParameterValue(ParamIDs::masterChainOrder)->load());
+    routing.returnPoint = static_cast<int>(apvts.getRawParameterValue(ParamIDs::fxReturnPoint)->load());
+    return routing;
+}
+
+void CR717Processor::publishRouting()
+{
+    const auto routing = getRequestedRouting();
+    fxGraph.publish(routing.compile());
+    publishedRoutingKey = routing.getKey();
+}
+
+// Message-thread work requested by the audio thread: routing, latency reporting and eco mode changes
+void CR717Processor::handleAsyncUpdate()
+{
+    if (getRequestedRouting().getKey() != publishedRoutingKey.load())
+        publishRouting();
+    
+    // setLatencySamples notifies the host, which may restart processing, so it never runs on the audio thread
+    if (getLatencySamples() != masterLatency.load())
+        setLatencySamples(masterLatency.load());
+    
+    // Eco mode changed: the send FX need re-preparing at the new rate, which allocates
+    if (getSampleRate() > 0.0 && getRequestedEcoFactor(getSampleRate()) != sendEcoFactor)
+    {
+        suspendProcessing(true);
+        prepareSendFX(getSampleRate(), juce::jmax(getBlockSize(), voiceBuffer.getNumSamples()));
+        suspendProcessing(false);
+    }
+}
+
 juce::AudioProcessorEditor* CR717Processor::createEditor()
 {
     return new CR717Editor(*this);
@@ -67,6 +208,10 @@ void CR717Processor::processBlock(juce::AudioBuffer<float>& buffer,
         voiceBuffer.setSize(2, numSamples, false, false, true);
         reverbBuffer.setSize(2, numSamples, false, false, true);
         delayBuffer.setSize(2, numSamples, false, false, true);
+        ducker.ensureCapacity(numSamples);
+        fxGraph.ensureCapacity(numSamples);
+        reverbResampler.prepare(numSamples, sendEcoFactor);
+        delayResampler.prepare(numSamples, sendEcoFactor);
     }
 
     // Update host info
@@ -82,57 +227,67 @@ void CR717Processor::processBlock(juce::AudioBuffer<float>& buffer,
 
     // Update voice parameters from APVTS
     updateVoiceParameters();
+    updateDuckerParameters();
 
-    // Process internal sequencer
-    if (sequencer.getPlaying())
+    // Internal sequencer: transport commands, then the hits that fall in this block. They
+    // start on their own sample, and fraction of one, when the voices render below (if the
+    // block has more than the table holds, the rest start at block start)
+    numBlockHits = 0;
+    sequencer.setHumanizeAmount(apvts.getRawParameterValue(ParamIDs::seqHumanize)->load());
+    sequencer.process(numSamples, [this](int sample, const Sequencer::Trigger& hit)
     {
-        double bpm = sequencer.getBPM();
-        double samplesPerStep = (60.0 / bpm / 4.0) * getSampleRate(); // 16th notes
-        
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            if (samplesUntilNextStep <= 0)
-            {
-                // Trigger voices for current step
-                int currentStep = sequencer.getCurrentStep();
-                Voice* voices[] = {&bassDrum, &snareDrum, &lowTom, &midTom, &highTom, &rimShot,
-                                   &clap, &closedHat, &openHat, &cymbal, &ride, &cowbell};
-                
-                for (int v = 0; v < 12; ++v)
-                {
-                    if (sequencer.getStep(v, currentStep))
-                    {
-                        bool accent = sequencer.getAccent(v, currentStep);
-                        float velocity = accent ? 1.0f : 0.8f;
-                        voices[v]->trigger(velocity);
-                    }
-                }
-                
-                // Advance to next step
-                sequencer.setCurrentStep((currentStep + 1) % 16);
-                samplesUntilNextStep = static_cast<int>(samplesPerStep);
-            }
-            samplesUntilNextStep--;
-        }
-    }
+        if (numBlockHits < blockHits.size())
+            blockHits[numBlockHits++] = { sample, hit };
+        else
+            startHit(hit);
+        if (voices[static_cast<size_t>(hit.voice)] == duckKeyVoice)
+            ducker.addTrigger(sample, hit.velocity);
+    });
 
     // Process MIDI events
     for (const auto metadata : midiMessages)
     {
         const auto msg = metadata.getMessage();
         if (msg.isNoteOn())
-            handleMidiMessage(msg);
+            handleMidiMessage(msg, metadata.samplePosition);
     }
 
+    // Ducking envelope for this block, keyed from the triggers collected above
+    ducker.renderGain(numSamples);
+    const bool duckingActive = duckKeyVoice != nullptr && !ducker.isIdle();
+    const bool duckVoices = duckingActive && apvts.getRawParameterValue(ParamIDs::duckVoices)->load() > 0.5f;
+
     // Render all active voices
     reverbBuffer.clear();
     delayBuffer.clear();
     
-    // Helper lambda to render voice with sends
+    // Helper lambda to render voice with sends. The voice renders up to each of its
+    // sequencer hits and is triggered there, so a ratchet's hits each ring until the next
     auto renderVoiceWithSends = [&](Voice& voice, const char* sendAID, const char* sendBID) {
-        if (voice.isActive()) {
-            voiceBuffer.clear();
-            voice.renderNextBlock(voiceBuffer, 0, numSamples);
+        bool rendered = false;
+        int position = 0;
+        auto renderUpTo = [&](int end) {
+            if (end > position && voice.isActive())
+            {
+                if (!rendered)
+                    voiceBuffer.clear();
+                voice.renderWithInserts(voiceBuffer, position, end - position);
+                rendered = true;
+            }
+            position = end;
+        };
+        for (size_t h = 0; h < numBlockHits; ++h)
+        {
+            if (voices[static_cast<size_t>(blockHits[h].trigger.voice)] != &voice)
+                continue;
+            renderUpTo(blockHits[h].sample);
+            startHit(blockHits[h].trigger);
+        }
+        renderUpTo(numSamples);
+        
+        if (rendered) {
+            if (duckVoices && &voice != duckKeyVoice)
+                ducker.apply(voiceBuffer, numSamples);
             
             float sendA = apvts.getRawParameterValue(sendAID)->load();
             float sendB = apvts.getRawParameterValue(sendBID)->load();
@@ -162,53 +317,51 @@ void CR717Processor::processBlock(juce::AudioBuffer<float>& buffer,
     // Update FX parameters
     updateFXParameters();
 
-    // Process FX buses
-    reverb.process(reverbBuffer);
-    delay.process(delayBuffer);
-    
-    // Mix FX returns
-    float reverbWet = apvts.getRawParameterValue(ParamIDs::reverbWet)->load();
-    float delayWet = apvts.getRawParameterValue(ParamIDs::delayWet)->load();
-    
-    for (int ch = 0; ch < 2; ++ch)
+    // Routing or eco mode changed: rebuilt on the message thread
+    if (getRequestedRouting().getKey() != publishedRoutingKey.load()
+        || getRequestedEcoFactor(getSampleRate()) != sendEcoFactor)
+        triggerAsyncUpdate();
+    
+    // Per-block state read by the graph nodes
+    duckReverbActive = duckingActive && apvts.getRawParameterValue(ParamIDs::duckReverb)->load() > 0.5f;
+    duckDelayActive = duckingActive && apvts.getRawParameterValue(ParamIDs::duckDelay)->load() > 0.5f;
+    compEnabled = apvts.getRawParameterValue(ParamIDs::compEnabled)->load() > 0.5f;
+    clipperEnabled = apvts.getRawParameterValue(ParamIDs::clipperEnabled)->load() > 0.5f;
+    limiterEnabled = apvts.getRawParameterValue(ParamIDs::limiterEnabled)->load() > 0.5f;
+    fxGraph.setGain(FxGraph::ReverbWet, apvts.getRawParameterValue(ParamIDs::reverbWet)->load());
+    fxGraph.setGain(FxGraph::DelayWet, apvts.getRawParameterValue(ParamIDs::delayWet)->load());
+    
+    // The chain this block runs: a routing change only takes effect once the message thread
+    // has published it, so latency and return delay follow the program, not the parameters
+    const auto routing = FxRouting::fromKey(fxGraph.acquire().routingKey);
+    const int latency = masterDynamics.getLatencySamples(compEnabled, limiterEnabled, clipperEnabled,
+                                                         routing.clipperFeedsLimiter());
+    if (latency != masterLatency.load())
     {
-        buffer.addFrom(ch, 0, reverbBuffer, ch, 0, numSamples, reverbWet);
-        buffer.addFrom(ch, 0, delayBuffer, ch, 0, numSamples, delayWet);
+        masterLatency = latency;
+        triggerAsyncUpdate();
     }
-
-    // Master dynamics
-    bool compEnabled = apvts.getRawParameterValue(ParamIDs::compEnabled)->load() > 0.5f;
-    bool clipperEnabled = apvts.getRawParameterValue(ParamIDs::clipperEnabled)->load() > 0.5f;
-    bool limiterEnabled = apvts.getRawParameterValue(ParamIDs::limiterEnabled)->load() > 0.5f;
-    masterDynamics.process(buffer, compEnabled, limiterEnabled, clipperEnabled);
+    
+    // Post-compressor returns skip the compressor (and, clipping first, the clipper): they
+    // are delayed by those stages' latency to meet the master bus in time
+    fxGraph.setReturnDelay(masterDynamics.getLatencySamples(compEnabled, false,
+                                                            clipperEnabled && !routing.clipperFeedsLimiter(), false));
+    
+    // Send FX, returns and master dynamics, in the published order
+    fxGraph.process(buffer, numSamples);
 
     // Apply master level
     float masterLevel = apvts.getRawParameterValue(ParamIDs::masterLevel)->load();
     buffer.applyGain(masterLevel);
 
-    // Metering: update peak and RMS per channel
-    const int numSamplesForMetering = buffer.getNumSamples();
-    const int numCh = juce::jmin(2, buffer.getNumChannels());
-    float maxAbs[2] = {0.0f, 0.0f};
-    float sumSq[2] = {0.0f, 0.0f};
-    for (int ch = 0; ch < numCh; ++ch)
-    {
-        const float* data = buffer.getReadPointer(ch);
-        float localMax = 0.0f;
-        float localSum = 0.0f;
-        for (int i = 0; i < numSamplesForMetering; ++i)
-        {
-            float s = data[i];
-            float a = std::abs(s);
-            if (a > localMax) localMax = a;
-            localSum += s * s;
-        }
-        maxAbs[ch] = localMax;
-        sumSq[ch] = localSum;
-        peakLevels[ch].store(juce::jmax(peakLevels[ch].load() * 0.95f, localMax));
-        rmsLevels[ch].store(std::sqrt(localSum / juce::jmax(1, numSamplesForMetering)));
-    }
-    clipping.store((maxAbs[0] > 0.999f) || (maxAbs[1] > 0.999f));
+    // Metering: peaks, RMS, loudness and true peak, queued for the editor
+    if (loudnessResetPending.exchange(false))
+        outputMeter.reset();
+    outputMeter.process(buffer.getReadPointer(0), buffer.getReadPointer(juce::jmin(1, buffer.getNumChannels() - 1)),
+                        buffer.getNumSamples());
+    
+    for (int band = 0; band < ThreeBandCrossover::NUM_BANDS; ++band)
+        compGainReduction[band].store(compEnabled ? masterDynamics.getBandGainReduction(band) : 0.0f);
 }
 
 void CR717Processor::updateVoiceParameters()
@@ -292,6 +445,19 @@ void CR717Processor::updateVoiceParameters()
     cowbell.setLevel(apvts.getRawParameterValue(ParamIDs::cbLevel)->load());
     cowbell.setTune(apvts.getRawParameterValue(ParamIDs::cbTune)->load());
     cowbell.setPan(apvts.getRawParameterValue(ParamIDs::cbPan)->load());
+    
+    // Insert FX slots
+    for (int v = 0; v < Sequencer::NUM_VOICES; ++v)
+    {
+        auto& chain = voices[v]->getInserts();
+        for (int s = 0; s < ParamIDs::numInsertSlots; ++s)
+        {
+            const auto& p = insertParams[v][s];
+            auto& slot = chain.getSlot(s);
+            slot.setType(static_cast<int>(p.type->load()));
+            slot.setParameters(p.a->load(), p.b->load(), p.c->load());
+        }
+    }
 }
 
 void CR717Processor::updateFXParameters()
@@ -301,10 +467,15 @@ void CR717Processor::updateFXParameters()
     reverb.setDamping(apvts.getRawParameterValue(ParamIDs::reverbDamp)->load());
     reverb.setWidth(apvts.getRawParameterValue(ParamIDs::reverbWidth)->load());
     reverb.setWetLevel(apvts.getRawParameterValue(ParamIDs::reverbWet)->load());
-    reverb.setPreDelay(apvts.getRawParameterValue(ParamIDs::reverbPreDelay)->load());
+    // In eco mode the resampler round trip already delays the return; take it out of the pre-delay
+    const float ecoLatencyMs = 1000.0f * static_cast<float>(reverbResampler.getLatencySamples() / getSampleRate());
+    reverb.setPreDelay(juce::jmax(0.0f, apvts.getRawParameterValue(ParamIDs::reverbPreDelay)->load() - ecoLatencyMs));
     reverb.setDiffusion(apvts.getRawParameterValue(ParamIDs::reverbDiffusion)->load());
     
-    // Delay
+    // Delay. Its return is late by the resampler round trip in eco mode too (47 samples at
+    // 1/2, 141 at 1/4: under 1 ms at 96k and up), but only the first echo: the repeats
+    // circulate inside the low-rate delay line and keep the synced spacing. Shortening the
+    // delay time instead would pull every repeat early, so the offset is left in
     float delayBeats = apvts.getRawParameterValue(ParamIDs::delayTime)->load();
     delay.setDelayTime(delayBeats, hostBPM);
     delay.setFeedback(apvts.getRawParameterValue(ParamIDs::delayFeedback)->load());
@@ -332,7 +503,16 @@ void CR717Processor::updateFXParameters()
     masterDynamics.setAutoMakeup(apvts.getRawParameterValue(ParamIDs::compAutoMakeup)->load() > 0.5f);
     masterDynamics.setScHpfFreq(apvts.getRawParameterValue(ParamIDs::compScHpf)->load());
     masterDynamics.setDetectorMode(apvts.getRawParameterValue(ParamIDs::compDetector)->load() > 0.5f);
+    masterDynamics.setRmsDetectorType(static_cast<int>(apvts.getRawParameterValue(ParamIDs::compRmsType)->load()));
     masterDynamics.setLookahead(apvts.getRawParameterValue(ParamIDs::compLookahead)->load());
+    masterDynamics.setLinkMode(static_cast<int>(apvts.getRawParameterValue(ParamIDs::compLink)->load()));
+    masterDynamics.setMix(apvts.getRawParameterValue(ParamIDs::compMix)->load());
+    masterDynamics.setBandMode(static_cast<int>(apvts.getRawParameterValue(ParamIDs::compBands)->load()));
+    masterDynamics.setCrossoverFrequencies(apvts.getRawParameterValue(ParamIDs::compXoverLow)->load(),
+                                           apvts.getRawParameterValue(ParamIDs::compXoverHigh)->load());
+    masterDynamics.setBandThresholdOffset(ThreeBandCrossover::Low, apvts.getRawParameterValue(ParamIDs::compLowThreshold)->load());
+    masterDynamics.setBandThresholdOffset(ThreeBandCrossover::Mid, apvts.getRawParameterValue(ParamIDs::compMidThreshold)->load());
+    masterDynamics.setBandThresholdOffset(ThreeBandCrossover::High, apvts.getRawParameterValue(ParamIDs::compHighThreshold)->load());
     
     // Limiter
     masterDynamics.setLimiterCeiling(apvts.getRawParameterValue(ParamIDs::limiterCeiling)->load());
@@ -346,10 +526,28 @@ void CR717Processor::updateFXParameters()
     masterDynamics.setClipperOutput(apvts.getRawParameterValue(ParamIDs::clipperOutput)->load());
     masterDynamics.setClipperMix(apvts.getRawParameterValue(ParamIDs::clipperMix)->load());
     masterDynamics.setClipperCurve(static_cast<int>(apvts.getRawParameterValue(ParamIDs::clipperCurve)->load()));
+    masterDynamics.setClipperAntialias(static_cast<int>(apvts.getRawParameterValue(ParamIDs::clipperAntialias)->load()));
     masterDynamics.setClipperOversampling(static_cast<int>(apvts.getRawParameterValue(ParamIDs::clipperOversampling)->load()));
 }
 
-void CR717Processor::handleMidiMessage(const juce::MidiMessage& msg)
+void CR717Processor::updateDuckerParameters()
+{
+    if (apvts.getRawParameterValue(ParamIDs::duckEnabled)->load() > 0.5f)
+    {
+        int source = static_cast<int>(apvts.getRawParameterValue(ParamIDs::duckSource)->load());
+        duckKeyVoice = voices[static_cast<size_t>(juce::jlimit(0, Sequencer::NUM_VOICES - 1, source))];
+    }
+    else
+    {
+        duckKeyVoice = nullptr;
+    }
+    
+    ducker.setDepth(apvts.getRawParameterValue(ParamIDs::duckDepth)->load());
+    ducker.setAttack(apvts.getRawParameterValue(ParamIDs::duckAttack)->load());
+    ducker.setRelease(apvts.getRawParameterValue(ParamIDs::duckRelease)->load());
+}
+
+void CR717Processor::handleMidiMessage(const juce::MidiMessage& msg, int samplePosition)
 {
     int note = msg.getNoteNumber();
     float velocity = msg.getVelocity() / 127.0f;
@@ -368,6 +566,8 @@ void CR717Processor::handleMidiMessage(const juce::MidiMessage& msg)
         }
         
         voice->trigger(velocity);
+        if (voice == duckKeyVoice)
+            ducker.addTrigger(samplePosition, velocity);
     }
 }
 
@@ -472,6 +672,16 @@ void CR717Processor::loadPreset(int index)
     apvts.getParameter(ParamIDs::masterLevel)->setValueNotifyingHost(preset.master);
 }
 
+void CR717Processor::startHit(const Sequencer::Trigger& hit)
+{
+    // Parameter locks and the ratchet pitch go straight to the voice for that hit, the APVTS never sees them
+    auto* voice = voices[static_cast<size_t>(hit.voice)];
+    for (int i = 0; i < hit.numLocks; ++i)
+        voice->lockParameter(static_cast<Voice::Param>(hit.locks[i].param), hit.locks[i].value);
+    voice->transposeNext(hit.transpose);
+    voice->trigger(hit.velocity, hit.fraction);
+}
+
 void CR717Processor::loadPreset(const Preset& preset)
 {
     // Load parameters
@@ -492,34 +702,49 @@ void CR717Processor::loadPreset(const Preset& preset)
         }
     }
     
-    // Load pattern into sequencer
-    for (int voice = 0; voice < 12; ++voice)
-    {
-        for (int step = 0; step < 16; ++step)
-        {
-            sequencer.setStep(voice, step, preset.pattern[voice][step]);
-        }
-    }
+    // Load pattern into sequencer, published as one snapshot; a running pattern finishes its bar
+    Sequencer::Pattern pattern;
+    for (int voice = 0; voice < Sequencer::NUM_VOICES; ++voice)
+        pattern.setSteps(voice, StepMask::fromArray(preset.pattern[static_cast<size_t>(voice)]));
+    sequencer.setPattern(pattern, Sequencer::Command::NextBar); // immediately when stopped
+    sequencer.setSwing(preset.swing); // held back with the pattern
+    const auto genre = PatternRandomizer::getGenreConfig(preset.style); // scaled by the Humanize amount
+    sequencer.setHumanize(genre.humanizeTiming, genre.humanizeVelocity);
     
     // Set BPM
     sequencer.setBPM(preset.bpm);
 }
 
+// Redraws every voice's steps in the edit slot for the current preset's style; track
+// lengths and rates stay, and the new steps come in on the next bar like a preset's
+void CR717Processor::randomizePattern(float amount)
+{
+    static const char* voiceNames[Sequencer::NUM_VOICES] = {"BD", "SD", "LT", "MT", "HT", "RS", "CP", "CH", "OH", "CY", "RD", "CB"};
+    const auto& presets = presetManager.getPresets();
+    const auto genre = juce::isPositiveAndBelow(currentPreset, static_cast<int>(presets.size()))
+                           ? presets[static_cast<size_t>(currentPreset)].style : juce::String();
+    
+    auto pattern = sequencer.getPattern();
+    for (int voice = 0; voice < Sequencer::NUM_VOICES; ++voice)
+        pattern.setSteps(voice, randomizer.generateSteps(voiceNames[voice], genre, amount));
+    sequencer.setPattern(pattern, Sequencer::Command::NextBar);
+}
+
 void CR717Processor::startSequencer()
 {
-    sequencer.setPlaying(true);
-    sequencer.setCurrentStep(0);
-    samplesUntilNextStep = 0;
+    sequencer.play(0);
 }
 
 void CR717Processor::stopSequencer()
 {
-    sequencer.setPlaying(false);
+    sequencer.stop();
 }
 
+// Parameters, with the sequencer's bank and song as one child of the tree
 void CR717Processor::getStateInformation(juce::MemoryBlock& destData)
 {
     auto state = apvts.copyState();
+    state.appendChild(sequencer.getState(), nullptr);
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
 }
@@ -528,7 +753,17 @@ void CR717Processor::setStateInformation(const void* data, int sizeInBytes)
 {
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState != nullptr && xmlState->hasTagName(apvts.state.getType()))
-        apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    {
+        // The sequencer's part is taken out, so it never ends up in the parameter state
+        auto state = juce::ValueTree::fromXml(*xmlState);
+        const auto sequencerState = state.getChildWithName("SEQUENCER");
+        if (sequencerState.isValid())
+        {
+            sequencer.setState(sequencerState);
+            state.removeChild(sequencerState, nullptr);
+        }
+        apvts.replaceState(state);
+    }
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
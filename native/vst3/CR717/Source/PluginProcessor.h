@@ -11,15 +11,20 @@
 #include "Reverb.h"
 #include "Delay.h"
 #include "MasterDynamics.h"
+#include "LoudnessMeter.h"
+#include "Ducker.h"
+#include "SendResampler.h"
+#include "FxGraph.h"
 #include "Preset.h"
 #include "PatternRandomizer.h"
 #include "Sequencer.h"
 
-class CR717Processor : public juce::AudioProcessor
+class CR717Processor : public juce::AudioProcessor,
+                       private juce::AsyncUpdater
 {
 public:
     CR717Processor();
-    ~CR717Processor() override = default;
+    ~CR717Processor() override { cancelPendingUpdate(); }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -50,13 +55,15 @@ public:
     Sequencer& getSequencer() { return sequencer; }
     
     void loadPreset(const Preset& preset);
+    void randomizePattern(float amount = 0.5f); // message thread
     void startSequencer();
     void stopSequencer();
 
     // Metering (UI thread safe queries)
-    float getPeakLevel(int channel) const { return peakLevels[channel].load(); }
-    float getRMSLevel(int channel) const { return rmsLevels[channel].load(); }
-    bool isClipping() const { return clipping.load(); }
+    // Output metering, read by the editor: every frame since the last call, oldest first
+    bool popMeterFrame(LoudnessMeter::Frame& frame) { return outputMeter.popFrame(frame); }
+    void resetLoudness() { loudnessResetPending = true; } // applied on the audio thread
+    float getCompressorGainReduction(int band) const { return compGainReduction[band].load(); } // dB, ThreeBandCrossover::Band
 
 private:
     juce::AudioProcessorValueTreeState apvts;
@@ -74,6 +81,28 @@ private:
     CymbalVoice cymbal;
     RideVoice ride;
     CowbellVoice cowbell;
+    
+    // Voice table in sequencer row order
+    std::array<Voice*, Sequencer::NUM_VOICES> voices;
+    
+    // This block's sequencer hits, in time order, started as the voices render
+    struct BlockHit
+    {
+        int sample = 0;
+        Sequencer::Trigger trigger;
+    };
+    std::array<BlockHit, 512> blockHits;
+    size_t numBlockHits = 0;
+    
+    // Insert FX parameters, resolved once so the audio thread never builds ID strings
+    struct InsertParamPointers
+    {
+        std::atomic<float>* type = nullptr;
+        std::atomic<float>* a = nullptr;
+        std::atomic<float>* b = nullptr;
+        std::atomic<float>* c = nullptr;
+    };
+    std::array<std::array<InsertParamPointers, ParamIDs::numInsertSlots>, Sequencer::NUM_VOICES> insertParams;
 
     double hostBPM = 120.0;
     bool hostIsPlaying = false;
@@ -83,24 +112,44 @@ private:
     AlgorithmicReverb reverb;
     TempoSyncDelay delay;
     MasterDynamics masterDynamics;
+    TriggerDucker ducker;
+    Voice* duckKeyVoice = nullptr; // nullptr when ducking is off
     juce::AudioBuffer<float> reverbBuffer, delayBuffer, voiceBuffer;
     
+    // Eco mode: reverb and delay run at 1/sendEcoFactor of the host rate
+    SendResampler reverbResampler, delayResampler;
+    int sendEcoFactor = 1;
+    
+    // Post-voice routing; the program is rebuilt on the message thread when the routing params change
+    FxGraph fxGraph;
+    std::atomic<int> publishedRoutingKey { -1 };
+    bool duckReverbActive = false, duckDelayActive = false;
+    bool compEnabled = true, clipperEnabled = false, limiterEnabled = true;
+    
+    // Master chain latency as last computed on the audio thread; reported to the host asynchronously
+    std::atomic<int> masterLatency { 0 };
+    
     PresetManager presetManager;
     PatternRandomizer randomizer;
     Sequencer sequencer;
-    
-    double nextStepTime = 0.0;
-    int samplesUntilNextStep = 0;
 
-    // Metering state (atomic for cross-thread use)
-    std::atomic<float> peakLevels[2] { 0.0f, 0.0f };
-    std::atomic<float> rmsLevels[2]  { 0.0f, 0.0f };
-    std::atomic<bool>  clipping { false };
+    // Metering: frames go to the editor through the meter's SPSC queue
+    LoudnessMeter outputMeter;
+    std::atomic<bool> loudnessResetPending { false };
+    std::atomic<float> compGainReduction[3] { 0.0f, 0.0f, 0.0f };
 
-    void handleMidiMessage(const juce::MidiMessage& msg);
+    void handleMidiMessage(const juce::MidiMessage& msg, int samplePosition);
+    void startHit(const Sequencer::Trigger& hit);
+    void updateDuckerParameters();
     Voice* getVoiceForNote(int noteNumber);
     void updateVoiceParameters();
     void updateFXParameters();
+    int getRequestedEcoFactor(double sampleRate) const;
+    int computeMasterLatency() const;
+    FxRouting getRequestedRouting() const;
+    void publishRouting();
+    void prepareSendFX(double sampleRate, int samplesPerBlock);
+    void handleAsyncUpdate() override;
     void loadPreset(int index);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CR717Processor)
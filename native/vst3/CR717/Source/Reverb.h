@@ -91,7 +91,12 @@ public:
 
     void process(juce::AudioBuffer<float>& buffer)
     {
-        juce::dsp::AudioBlock<float> block(buffer);
+        process(buffer, buffer.getNumSamples());
+    }
+
+    void process(juce::AudioBuffer<float>& buffer, int numSamples)
+    {
+        auto block = juce::dsp::AudioBlock<float>(buffer).getSubBlock(0, static_cast<size_t>(numSamples));
         
         // Apply pre-delay
         juce::dsp::ProcessContextReplacing<float> preDelayContext(block);
@@ -100,8 +105,7 @@ public:
         // Apply pre-diffusion via two all-pass stages per channel
         auto* left = buffer.getWritePointer(0);
         auto* right = buffer.getWritePointer(1);
-        int n = buffer.getNumSamples();
-        for (int i = 0; i < n; ++i)
+        for (int i = 0; i < numSamples; ++i)
         {
             left[i]  = diffuserL2.processSample(0, diffuserL1.processSample(0, left[i]));
             right[i] = diffuserR2.processSample(1, diffuserR1.processSample(1, right[i]));
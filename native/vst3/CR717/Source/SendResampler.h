@@ -0,0 +1,286 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <array>
+
+/**
+ * Polyphase half-band resampling for the send buses ("eco" mode).
+ * A 47-tap half-band FIR (Blackman-windowed sinc) has every other tap zero, so each
+ * 2x stage runs as a 24-tap filter on one phase plus a pure delay on the other,
+ * at the low rate. 4x is two cascaded stages.
+ */
+namespace HalfBand
+{
+    static constexpr int NUM_TAPS = 47;
+    static constexpr int CENTRE = (NUM_TAPS - 1) / 2;   // 23
+    static constexpr int PHASE_TAPS = (NUM_TAPS + 1) / 2; // non-zero taps on the even phase
+
+    // Even-phase taps h[2k]; the odd phase is a single 0.5 tap at the centre
+    inline const std::array<float, PHASE_TAPS>& getPhaseTaps()
+    {
+        static const auto taps = []
+        {
+            std::array<float, PHASE_TAPS> t{};
+            const double pi = juce::MathConstants<double>::pi;
+            for (int k = 0; k < PHASE_TAPS; ++k)
+            {
+                const int n = 2 * k;
+                const double m = n - CENTRE;
+                const double sinc = std::sin(0.5 * pi * m) / (pi * m);
+                const double w = 0.42 - 0.5 * std::cos(2.0 * pi * n / (NUM_TAPS - 1))
+                                      + 0.08 * std::cos(4.0 * pi * n / (NUM_TAPS - 1));
+                t[static_cast<size_t>(k)] = static_cast<float>(sinc * w);
+            }
+
+            // Normalise so the even phase sums to exactly 0.5 (unity DC gain overall)
+            double sum = 0.0;
+            for (auto v : t) sum += v;
+            for (auto& v : t) v = static_cast<float>(v * 0.5 / sum);
+            return t;
+        }();
+        return taps;
+    }
+
+    /**
+     * One stage's input in time order: the last PHASE_TAPS - 1 samples of the previous
+     * chunk, then up to CHUNK new ones. The filters run tap by tap over a whole chunk of
+     * outputs, so the inner loop is a plain multiply-add over consecutive samples that
+     * vectorises, rather than a dot product per output on one accumulator.
+     */
+    struct Line
+    {
+        static constexpr int CHUNK = 64;
+        static constexpr int HISTORY = PHASE_TAPS - 1;
+        std::array<float, HISTORY + CHUNK> buf{};
+
+        // The newest sample of output i in the chunk is at x[i]
+        float* x() { return buf.data() + HISTORY; }
+
+        // sum_k taps[k] x[i - k], added into out[0..n)
+        void convolve(const float* taps, float* out, int n) const
+        {
+            const float* newest = buf.data() + HISTORY;
+            for (int k = 0; k < PHASE_TAPS; ++k)
+            {
+                const float t = taps[k];
+                const float* in = newest - k;
+                for (int i = 0; i < n; ++i)
+                    out[i] += t * in[i];
+            }
+        }
+
+        // Keeps the history for the next chunk after n new samples
+        void advance(int n) { std::copy(buf.begin() + n, buf.begin() + n + HISTORY, buf.begin()); }
+
+        void reset() { buf.fill(0.0f); }
+    };
+
+    // 2:1 decimator, y[m] = sum_k h[2k] x[2m - 2k] + 0.5 x[2m - CENTRE]
+    struct Decimator
+    {
+        Line even, odd;
+
+        // numIn must be even; writes numIn / 2 samples
+        void process(const float* in, float* out, int numIn)
+        {
+            const float* taps = getPhaseTaps().data();
+            const int numOut = numIn / 2;
+            for (int done = 0; done < numOut; done += Line::CHUNK)
+            {
+                const int n = std::min(Line::CHUNK, numOut - done);
+                float* e = even.x();
+                float* o = odd.x();
+                for (int i = 0; i < n; ++i)
+                {
+                    e[i] = in[2 * (done + i)];
+                    o[i] = in[2 * (done + i) + 1];
+                }
+
+                float* y = out + done;
+                for (int i = 0; i < n; ++i)
+                    y[i] = 0.5f * o[i - (CENTRE + 1) / 2];
+                even.convolve(taps, y, n);
+
+                even.advance(n);
+                odd.advance(n);
+            }
+        }
+
+        void reset() { even.reset(); odd.reset(); }
+    };
+
+    // 1:2 interpolator (zero-stuff + 2h), writes 2 * numIn samples
+    struct Interpolator
+    {
+        Line line;
+        std::array<float, Line::CHUNK> acc{};
+
+        void process(const float* in, float* out, int numIn)
+        {
+            const float* taps = getPhaseTaps().data();
+            for (int done = 0; done < numIn; done += Line::CHUNK)
+            {
+                const int n = std::min(Line::CHUNK, numIn - done);
+                float* x = line.x();
+                std::copy(in + done, in + done + n, x);
+
+                std::fill(acc.begin(), acc.begin() + n, 0.0f);
+                line.convolve(taps, acc.data(), n);
+
+                float* y = out + 2 * done;
+                for (int i = 0; i < n; ++i)
+                {
+                    y[2 * i] = 2.0f * acc[static_cast<size_t>(i)];
+                    y[2 * i + 1] = x[i - (CENTRE - 1) / 2];
+                }
+
+                line.advance(n);
+            }
+        }
+
+        void reset() { line.reset(); }
+    };
+}
+
+/**
+ * Runs a stereo send bus at 1/2 or 1/4 of the host rate.
+ * Host blocks of any length are accepted: up to factor-1 input samples are carried
+ * into the next block and the output is primed with factor-1 samples, so the low-rate
+ * block length varies by at most one sample while the host block is always filled.
+ */
+class SendResampler
+{
+public:
+    static constexpr int MAX_FACTOR = 4;
+
+    void prepare(int maxBlockSize, int newFactor)
+    {
+        factor = (newFactor >= 4) ? 4 : (newFactor >= 2 ? 2 : 1);
+        const int maxHigh = maxBlockSize + MAX_FACTOR;
+        highScratch.setSize(2, maxHigh);
+        midScratch.setSize(2, maxHigh / 2 + 1);
+        lowBuffer.setSize(2, factor == 1 ? maxBlockSize : getMaxLowBlockSize(maxBlockSize));
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+    static int getMaxLowBlockSize(int maxBlockSize) { return maxBlockSize / 2 + MAX_FACTOR; }
+
+    // Round-trip delay of the FIR stages plus the block priming, in host-rate samples
+    int getLatencySamples() const
+    {
+        if (factor == 1) return 0;
+        const int stageDelay = 2 * HalfBand::CENTRE; // decimator + interpolator, at the stage's high rate
+        return (factor == 2 ? stageDelay : stageDelay + 2 * stageDelay) + (factor - 1);
+    }
+
+    // Decimates numSamples of input; returns the number of low-rate samples in getLowBuffer()
+    int down(const juce::AudioBuffer<float>& input, int numSamples)
+    {
+        if (factor == 1)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                lowBuffer.copyFrom(ch, 0, input, ch, 0, numSamples);
+            return lowSamples = numSamples;
+        }
+
+        const int total = inResidue + numSamples;
+        const int consumed = total - (total % factor);
+        const int newResidue = total - consumed;
+        lowSamples = consumed / factor;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto& s = state[static_cast<size_t>(ch)];
+            float* high = highScratch.getWritePointer(ch);
+
+            std::copy(s.inPending.begin(), s.inPending.begin() + inResidue, high);
+            std::copy(input.getReadPointer(ch), input.getReadPointer(ch) + numSamples, high + inResidue);
+
+            if (factor == 4)
+            {
+                float* mid = midScratch.getWritePointer(ch);
+                s.down1.process(high, mid, consumed);
+                s.down2.process(mid, lowBuffer.getWritePointer(ch), consumed / 2);
+            }
+            else
+            {
+                s.down1.process(high, lowBuffer.getWritePointer(ch), consumed);
+            }
+
+            std::copy(high + consumed, high + total, s.inPending.begin());
+        }
+
+        inResidue = newResidue;
+        return lowSamples;
+    }
+
+    juce::AudioBuffer<float>& getLowBuffer() { return lowBuffer; }
+
+    // Interpolates the processed low-rate block back into numSamples of output
+    void up(juce::AudioBuffer<float>& output, int numSamples)
+    {
+        if (factor == 1)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                output.copyFrom(ch, 0, lowBuffer, ch, 0, numSamples);
+            return;
+        }
+
+        const int produced = lowSamples * factor;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto& s = state[static_cast<size_t>(ch)];
+            float* high = highScratch.getWritePointer(ch);
+
+            std::copy(s.outPending.begin(), s.outPending.begin() + outResidue, high);
+
+            if (factor == 4)
+            {
+                float* mid = midScratch.getWritePointer(ch);
+                s.up2.process(lowBuffer.getReadPointer(ch), mid, lowSamples);
+                s.up1.process(mid, high + outResidue, lowSamples * 2);
+            }
+            else
+            {
+                s.up1.process(lowBuffer.getReadPointer(ch), high + outResidue, lowSamples);
+            }
+
+            const int available = outResidue + produced;
+            std::copy(high, high + numSamples, output.getWritePointer(ch));
+            std::copy(high + numSamples, high + available, s.outPending.begin());
+        }
+
+        outResidue = outResidue + produced - numSamples;
+    }
+
+    void reset()
+    {
+        for (auto& s : state)
+        {
+            s.down1.reset(); s.down2.reset();
+            s.up1.reset(); s.up2.reset();
+            s.inPending.fill(0.0f);
+            s.outPending.fill(0.0f);
+        }
+        inResidue = 0;
+        outResidue = factor - 1; // priming keeps every host block fully covered
+        lowSamples = 0;
+    }
+
+private:
+    struct ChannelState
+    {
+        HalfBand::Decimator down1, down2;
+        HalfBand::Interpolator up1, up2;
+        std::array<float, MAX_FACTOR> inPending{};
+        std::array<float, MAX_FACTOR> outPending{};
+    };
+
+    int factor = 1;
+    std::array<ChannelState, 2> state;
+    juce::AudioBuffer<float> highScratch, midScratch, lowBuffer;
+    int inResidue = 0, outResidue = 0, lowSamples = 0;
+};
@@ -1,86 +1,914 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "SpscQueue.h"
+#include "StepMask.h"
+#include "TripleBuffer.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
 
+/**
+ * Step sequencer state shared by the editor and the audio thread.
+ *
+ * The pattern is edited on the message thread only, in a private copy; every edit
+ * compiles it, with swing and accents, into one sorted list of (tick, voice, velocity)
+ * events per track, and publishes that through a triple buffer. The audio thread takes
+ * the newest timeline once per block, so an edit (or a 192-step preset load) lands all
+ * at once on a block boundary and never half-applied, and the scheduler only walks
+ * indices from one event to the next: no per-sample countdown, no pattern scan. Tracks
+ * have their own length and clock, so they drift against the 16-step bar (polymeter).
+ *
+ * There are 64 pattern slots, each compiled and published on its own, and a song of
+ * (slot, bars) entries. The audio thread switches slots by index on bar boundaries, so
+ * an arrangement costs the same per block as looping one pattern.
+ *
+ * Transport changes (play, stop, locate, tempo, pattern change) go the same way as
+ * commands in an SPSC queue, applied by the audio thread at block start or quantised to
+ * the next step / bar boundary, always on an exact sample. The audio thread reports each
+ * step it plays, with its sample time, through a second queue back to the editor.
+ *
+ * Trig conditions, probability and humanisation are decided by the audio thread as each
+ * hit comes up, from a counter-based RNG: a hit's dice depend only on the seed and where
+ * the hit is, so a render from the same seed plays the same hits, at the same samples,
+ * whatever the block size.
+ */
 class Sequencer
 {
 public:
     static constexpr int NUM_STEPS = 16;
     static constexpr int NUM_VOICES = 12;
+    static constexpr int TICKS_PER_STEP = 960; // per 16th, the transport step
+    static constexpr int NUM_SLOTS = 64;       // pattern bank
     
+    // Per-track clock: how long one step of that track lasts
+    enum Rate { ThirtySecond = 0, SixteenthTriplet, Sixteenth, EighthTriplet, Eighth, Quarter };
+    
+    static int ticksPerStep(Rate rate)
+    {
+        static constexpr int ticks[] = {480, 640, 960, 1280, 1920, 3840};
+        return ticks[juce::jlimit(0, 5, static_cast<int>(rate))];
+    }
+    
+    // A per-step override of one voice parameter (a p-lock)
+    struct ParamLock
+    {
+        std::uint16_t key = 0;   // voice * 64 + step
+        std::uint8_t param = 0;  // Voice::Param
+        float value = 0.0f;      // plain value, in the parameter's own units
+    };
+    
+    // When a step plays, checked each time the track comes round to it
+    struct Condition
+    {
+        enum Kind : std::uint8_t { Always = 0, Ratio, Fill, NotFill, First };
+        
+        Kind kind = Always;
+        std::uint8_t a = 1, b = 1; // Ratio: the a-th of every b loops of the track (1:2, 3:4 ...)
+        
+        static Condition ratio(int a, int b)
+        {
+            const int loops = juce::jlimit(1, 8, b);
+            return {Ratio, static_cast<std::uint8_t>(juce::jlimit(1, loops, a)), static_cast<std::uint8_t>(loops)};
+        }
+    };
+    
+    // A step played as a roll: count hits spread evenly over the step
+    struct Ratchet
+    {
+        std::uint8_t count = 1;       // 1 (a plain hit), 2, 3, 4, 6 or 8
+        std::int8_t velocityRamp = 0; // %: > 0 rolls up to the step's velocity, < 0 falls away from it
+        std::int8_t pitchRamp = 0;    // semitones from the first hit to the last, for tuned voices (toms)
+    };
+    
+    /**
+     * One on-mask and one accent mask per voice (see StepMask.h); accents only sit on
+     * active steps. Each voice is its own track with a length of 1-64 steps and a rate,
+     * looping independently of the 16-step transport bar (polymeter).
+     *
+     * Parameter locks live in one small table sorted by (voice, step, param), so a
+     * pattern with none costs nothing and a step's locks are one contiguous run.
+     * Every step also has a trig condition and a probability (in percent), which the
+     * audio thread rolls each time the step comes round, a ratchet count, and a
+     * micro-timing nudge in 1/960ths of a track step (up to half a step either way).
+     */
     struct Pattern
     {
-        struct Step { bool on = false; bool accent = false; };
-        std::array<std::array<Step, NUM_STEPS>, NUM_VOICES> steps{};
+        static constexpr int MAX_LOCKS = 256;
+        static constexpr int MICRO_PER_STEP = 960; // micro-timing resolution
+        
+        std::array<std::uint64_t, NUM_VOICES> on{};
+        std::array<std::uint64_t, NUM_VOICES> accent{};
+        std::array<int, NUM_VOICES> length{};
+        std::array<Rate, NUM_VOICES> rate{};
+        std::array<ParamLock, MAX_LOCKS> locks{};
+        int numLocks = 0;
+        std::array<std::array<Condition, StepMask::MAX_STEPS>, NUM_VOICES> conditions{};
+        std::array<std::array<std::uint8_t, StepMask::MAX_STEPS>, NUM_VOICES> probability{};
+        std::array<std::array<Ratchet, StepMask::MAX_STEPS>, NUM_VOICES> ratchets{};
+        std::array<std::array<std::int16_t, StepMask::MAX_STEPS>, NUM_VOICES> microTiming{};
+        
+        Pattern()
+        {
+            length.fill(NUM_STEPS);
+            rate.fill(Sixteenth);
+            clearTrigs();
+        }
         
+        // Steps, accents, locks and per-step trig settings; lengths and rates stay
         void clear()
         {
-            for (auto& voice : steps)
-            {
-                for (auto& s : voice)
-                    s = {};
-            }
+            on.fill(0);
+            accent.fill(0);
+            numLocks = 0;
+            clearTrigs();
         }
         
         void setStep(int voice, int step, bool active)
         {
-            if (voice >= 0 && voice < NUM_VOICES && step >= 0 && step < NUM_STEPS)
-                steps[voice][step].on = active;
+            if (isValid(voice, step))
+            {
+                const auto bit = std::uint64_t{1} << step;
+                auto& steps = on[static_cast<size_t>(voice)];
+                steps = active ? (steps | bit) : (steps & ~bit);
+                accent[static_cast<size_t>(voice)] &= steps;
+                if (!active)
+                    clearTrig(voice, step);
+            }
         }
         
         void setStep(int voice, int step, bool active, bool isAccent)
         {
-            if (voice >= 0 && voice < NUM_VOICES && step >= 0 && step < NUM_STEPS)
-            {
-                steps[voice][step].on = active;
-                steps[voice][step].accent = isAccent && active;
-            }
+            setStep(voice, step, active);
+            setAccent(voice, step, isAccent);
         }
         
         void setAccent(int voice, int step, bool isAccent)
         {
-            if (voice >= 0 && voice < NUM_VOICES && step >= 0 && step < NUM_STEPS)
-                steps[voice][step].accent = isAccent && steps[voice][step].on;
+            if (isValid(voice, step))
+            {
+                const auto bit = std::uint64_t{1} << step;
+                auto& accents = accent[static_cast<size_t>(voice)];
+                accents = (isAccent ? (accents | bit) : (accents & ~bit)) & on[static_cast<size_t>(voice)];
+            }
         }
         
         bool getStep(int voice, int step) const
         {
-            if (voice >= 0 && voice < NUM_VOICES && step >= 0 && step < NUM_STEPS)
-                return steps[voice][step].on;
-            return false;
+            return isValid(voice, step) && StepMask::test(on[static_cast<size_t>(voice)], step);
         }
         
         bool getAccent(int voice, int step) const
         {
-            if (voice >= 0 && voice < NUM_VOICES && step >= 0 && step < NUM_STEPS)
-                return steps[voice][step].accent;
+            return isValid(voice, step) && StepMask::test(accent[static_cast<size_t>(voice)], step);
+        }
+        
+        // Whole-voice edits. length is the track length the operation wraps at
+        std::uint64_t getSteps(int voice) const { return isValid(voice, 0) ? on[static_cast<size_t>(voice)] : 0; }
+        std::uint64_t getAccents(int voice) const { return isValid(voice, 0) ? accent[static_cast<size_t>(voice)] : 0; }
+        
+        // Steps switched off lose their locks and trig settings, as with setStep
+        void setSteps(int voice, std::uint64_t steps, std::uint64_t accents = 0)
+        {
+            if (isValid(voice, 0))
+            {
+                for (auto cleared = on[static_cast<size_t>(voice)] & ~steps; cleared != 0; cleared &= cleared - 1)
+                    clearTrig(voice, StepMask::lowest(cleared));
+                on[static_cast<size_t>(voice)] = steps;
+                accent[static_cast<size_t>(voice)] = accents & steps;
+            }
+        }
+        
+        // Adds steps (and accents) on top of what the voice already plays
+        void merge(int voice, std::uint64_t steps, std::uint64_t accents = 0)
+        {
+            setSteps(voice, getSteps(voice) | steps, getAccents(voice) | (accents & steps));
+        }
+        
+        // Locks and per-step trig settings move with their steps
+        void rotate(int voice, int amount, int trackLength)
+        {
+            if (!isValid(voice, 0))
+                return;
+            
+            // Every step moves, none is switched off: the masks are assigned as they are
+            on[static_cast<size_t>(voice)] = StepMask::rotate(getSteps(voice), amount, trackLength);
+            accent[static_cast<size_t>(voice)] = StepMask::rotate(getAccents(voice), amount, trackLength);
+            
+            trackLength = juce::jlimit(1, StepMask::MAX_STEPS, trackLength);
+            const int shift = ((amount % trackLength) + trackLength) % trackLength;
+            rotateTrack(conditions[static_cast<size_t>(voice)], shift, trackLength);
+            rotateTrack(probability[static_cast<size_t>(voice)], shift, trackLength);
+            rotateTrack(ratchets[static_cast<size_t>(voice)], shift, trackLength);
+            rotateTrack(microTiming[static_cast<size_t>(voice)], shift, trackLength);
+            for (int i = 0; i < numLocks; ++i)
+            {
+                auto& lock = locks[static_cast<size_t>(i)];
+                const int step = lock.key % StepMask::MAX_STEPS;
+                if (lock.key / StepMask::MAX_STEPS == voice && step < trackLength)
+                    lock.key = lockKey(voice, (step + shift) % trackLength);
+            }
+            std::sort(locks.begin(), locks.begin() + numLocks, lockOrder);
+        }
+        
+        // Rests become hits and hits rests (unaccented); steps past trackLength are cleared
+        void invert(int voice, int trackLength)
+        {
+            setSteps(voice, StepMask::invert(getSteps(voice), trackLength));
+        }
+        
+        void euclidean(int voice, int hits, int trackLength, int rotation = 0)
+        {
+            setSteps(voice, StepMask::euclidean(hits, trackLength, rotation));
+        }
+        
+        // The same over the voice's own length
+        void rotate(int voice, int amount) { rotate(voice, amount, getLength(voice)); }
+        void invert(int voice) { invert(voice, getLength(voice)); }
+        void euclidean(int voice, int hits) { euclidean(voice, hits, getLength(voice)); }
+        
+        void setLength(int voice, int steps)
+        {
+            if (isValid(voice, 0))
+                length[static_cast<size_t>(voice)] = juce::jlimit(1, StepMask::MAX_STEPS, steps);
+        }
+        
+        void setRate(int voice, Rate newRate)
+        {
+            if (isValid(voice, 0))
+                rate[static_cast<size_t>(voice)] = newRate;
+        }
+        
+        int getLength(int voice) const { return isValid(voice, 0) ? length[static_cast<size_t>(voice)] : NUM_STEPS; }
+        Rate getRate(int voice) const { return isValid(voice, 0) ? rate[static_cast<size_t>(voice)] : Sixteenth; }
+        
+        int density(int voice) const { return StepMask::count(getSteps(voice)); }
+        
+        void setCondition(int voice, int step, Condition condition)
+        {
+            if (isValid(voice, step))
+                conditions[static_cast<size_t>(voice)][static_cast<size_t>(step)] = condition;
+        }
+        
+        Condition getCondition(int voice, int step) const
+        {
+            return isValid(voice, step) ? conditions[static_cast<size_t>(voice)][static_cast<size_t>(step)] : Condition{};
+        }
+        
+        // Chance, 0-100 %, that the step plays when its condition holds
+        void setProbability(int voice, int step, int percent)
+        {
+            if (isValid(voice, step))
+                probability[static_cast<size_t>(voice)][static_cast<size_t>(step)] = static_cast<std::uint8_t>(juce::jlimit(0, 100, percent));
+        }
+        
+        int getProbability(int voice, int step) const
+        {
+            return isValid(voice, step) ? probability[static_cast<size_t>(voice)][static_cast<size_t>(step)] : 100;
+        }
+        
+        // count snaps down to 1, 2, 3, 4, 6 or 8; velocityRamp is -100..100 %, pitchRamp -24..24 semitones
+        void setRatchet(int voice, int step, int count, int velocityRamp = 0, int pitchRamp = 0)
+        {
+            if (!isValid(voice, step))
+                return;
+            static constexpr int counts[] = {1, 2, 3, 4, 6, 8};
+            const int snapped = *std::prev(std::upper_bound(std::begin(counts), std::end(counts), juce::jlimit(1, 8, count)));
+            ratchets[static_cast<size_t>(voice)][static_cast<size_t>(step)] = {static_cast<std::uint8_t>(snapped),
+                static_cast<std::int8_t>(juce::jlimit(-100, 100, velocityRamp)), static_cast<std::int8_t>(juce::jlimit(-24, 24, pitchRamp))};
+        }
+        
+        Ratchet getRatchet(int voice, int step) const
+        {
+            return isValid(voice, step) ? ratchets[static_cast<size_t>(voice)][static_cast<size_t>(step)] : Ratchet{};
+        }
+        
+        // Nudge in track steps, -0.5 (half a step early) to 0.5 (half a step late)
+        void setMicroTiming(int voice, int step, float steps)
+        {
+            if (isValid(voice, step))
+                microTiming[static_cast<size_t>(voice)][static_cast<size_t>(step)]
+                    = static_cast<std::int16_t>(juce::roundToInt(juce::jlimit(-0.5f, 0.5f, steps) * MICRO_PER_STEP));
+        }
+        
+        float getMicroTiming(int voice, int step) const
+        {
+            return isValid(voice, step) ? microTiming[static_cast<size_t>(voice)][static_cast<size_t>(step)] / static_cast<float>(MICRO_PER_STEP) : 0.0f;
+        }
+        
+        // Adds or replaces a lock; false when the table is full (or the step is out of range)
+        bool setLock(int voice, int step, int param, float value)
+        {
+            if (!isValid(voice, step) || param < 0 || param > 255)
+                return false;
+            const ParamLock lock { lockKey(voice, step), static_cast<std::uint8_t>(param), value };
+            auto* end = locks.data() + numLocks;
+            auto* it = std::lower_bound(locks.data(), end, lock, lockOrder);
+            if (it != end && it->key == lock.key && it->param == lock.param)
+            {
+                it->value = value;
+                return true;
+            }
+            if (numLocks == MAX_LOCKS)
+                return false;
+            std::move_backward(it, end, end + 1);
+            *it = lock;
+            ++numLocks;
+            return true;
+        }
+        
+        bool getLock(int voice, int step, int param, float& value) const
+        {
+            const auto range = findLocks(voice, step);
+            for (int i = range.first; i < range.second; ++i)
+            {
+                if (locks[static_cast<size_t>(i)].param == param)
+                {
+                    value = locks[static_cast<size_t>(i)].value;
+                    return true;
+                }
+            }
             return false;
         }
+        
+        void clearLock(int voice, int step, int param)
+        {
+            const auto range = findLocks(voice, step);
+            for (int i = range.first; i < range.second; ++i)
+                if (locks[static_cast<size_t>(i)].param == param)
+                    return erase(i, i + 1);
+        }
+        
+        void clearLocks(int voice, int step)
+        {
+            const auto range = findLocks(voice, step);
+            erase(range.first, range.second);
+        }
+        
+        // Index range [first, second) of a step's locks, ordered by param
+        std::pair<int, int> findLocks(int voice, int step) const
+        {
+            if (!isValid(voice, step) || numLocks == 0)
+                return {0, 0};
+            const auto key = lockKey(voice, step);
+            const auto* begin = locks.data();
+            const auto* first = std::lower_bound(begin, begin + numLocks, key,
+                [](const ParamLock& l, std::uint16_t k) { return l.key < k; });
+            const auto* last = std::upper_bound(first, begin + numLocks, key,
+                [](std::uint16_t k, const ParamLock& l) { return k < l.key; });
+            return {static_cast<int>(first - begin), static_cast<int>(last - begin)};
+        }
+        
+    private:
+        static bool isValid(int voice, int step)
+        {
+            return voice >= 0 && voice < NUM_VOICES && step >= 0 && step < StepMask::MAX_STEPS;
+        }
+        
+        static std::uint16_t lockKey(int voice, int step) { return static_cast<std::uint16_t>(voice * StepMask::MAX_STEPS + step); }
+        
+        static bool lockOrder(const ParamLock& a, const ParamLock& b)
+        {
+            return a.key != b.key ? a.key < b.key : a.param < b.param;
+        }
+        
+        // One switched-off step: its locks go, its trig settings return to the defaults
+        void clearTrig(int voice, int step)
+        {
+            clearLocks(voice, step);
+            setCondition(voice, step, {});
+            setProbability(voice, step, 100);
+            setRatchet(voice, step, 1);
+            setMicroTiming(voice, step, 0.0f);
+        }
+        
+        void clearTrigs()
+        {
+            for (auto& track : conditions)
+                track.fill({});
+            for (auto& track : probability)
+                track.fill(100);
+            for (auto& track : ratchets)
+                track.fill({});
+            for (auto& track : microTiming)
+                track.fill(0);
+        }
+        
+        template <typename T>
+        static void rotateTrack(std::array<T, StepMask::MAX_STEPS>& steps, int shift, int trackLength)
+        {
+            std::rotate(steps.begin(), steps.begin() + (trackLength - shift), steps.begin() + trackLength);
+        }
+        
+        void erase(int first, int last)
+        {
+            std::move(locks.begin() + last, locks.begin() + numLocks, locks.begin() + first);
+            numLocks -= last - first;
+        }
     };
     
-    Sequencer() { pattern.clear(); }
+    struct Event
+    {
+        int tick = 0;  // from the start of the track loop
+        float velocity = 0.0f;
+        float transpose = 0.0f; // semitones, ratchet pitch ramp
+        std::uint16_t firstLock = 0, numLocks = 0; // into Timeline::locks
+        Condition condition;
+        std::uint8_t probability = 100;
+        std::uint8_t voice = 0;
+        std::uint8_t step = 0; // the hits of a ratchet share their step's dice
+    };
     
-    void setStep(int voice, int step, bool active) { pattern.setStep(voice, step, active); }
-    void setStep(int voice, int step, bool active, bool accent) { pattern.setStep(voice, step, active, accent); }
-    void setAccent(int voice, int step, bool accent) { pattern.setAccent(voice, step, accent); }
-    bool getStep(int voice, int step) const { return pattern.getStep(voice, step); }
-    bool getAccent(int voice, int step) const { return pattern.getAccent(voice, step); }
+    // What the audio thread hands to the voice for one hit
+    struct Trigger
+    {
+        int voice = 0;
+        float velocity = 0.0f;
+        const ParamLock* locks = nullptr; // overrides for this hit only
+        int numLocks = 0;
+        float transpose = 0.0f; // semitones on top of the voice's tune, this hit only
+        float fraction = 0.0f;  // 0-1: how far the exact hit time lies before its sample offset
+    };
     
-    void setCurrentStep(int step) { currentStep = step % NUM_STEPS; }
-    int getCurrentStep() const { return currentStep; }
+    // One voice's compiled loop: its hits in play order, a run of Timeline::events
+    struct Track
+    {
+        int firstEvent = 0;
+        int numEvents = 0;
+        int lengthTicks = NUM_STEPS * TICKS_PER_STEP;
+    };
     
-    void setPlaying(bool shouldPlay) { isPlaying = shouldPlay; }
-    bool getPlaying() const { return isPlaying; }
-    void togglePlayback() { isPlaying = !isPlaying; }
+    // A compiled pattern: one track per voice. Tracks loop on their own, so there is no
+    // common cycle to flatten them into (it would be the LCM of all the lengths)
+    struct Timeline
+    {
+        // Every step of every track once, plus room for ratchets
+        static constexpr int MAX_EVENTS = 1024;
+        
+        std::array<Track, NUM_VOICES> tracks{};
+        std::array<Event, MAX_EVENTS> events{};
+        std::array<ParamLock, Pattern::MAX_LOCKS> locks{}; // the pattern's table, events index into it
+        
+        const Event& event(int voice, int index) const
+        {
+            return events[static_cast<size_t>(tracks[static_cast<size_t>(voice)].firstEvent + index)];
+        }
+        
+        // Index in the voice's track of its first event at or after tick
+        int seek(int voice, int tick) const
+        {
+            const auto& track = tracks[static_cast<size_t>(voice)];
+            const auto* begin = events.data() + track.firstEvent;
+            return static_cast<int>(std::lower_bound(begin, begin + track.numEvents, tick,
+                [](const Event& e, int t) { return e.tick < t; }) - begin);
+        }
+        
+        /**
+         * Message thread. Swing is MPC-style, the share of two track steps before the
+         * odd step: 0.5 (or 0) is straight, 0.66 a triplet shuffle, 0.75 the hardest.
+         *
+         * A ratchet becomes that many events, evenly spaced up to the next step, each
+         * with its point on the velocity and pitch ramps. Every step gets its first hit;
+         * ratchets take the room left in the event table in voice and step order, and
+         * one that does not fit plays as a single hit.
+         *
+         * Micro-timing moves a step (and its whole ratchet) in ticks, so it scales with
+         * tempo like everything else; it never moves a hit out of its track loop.
+         */
+        static void compile(const Pattern& pattern, float swing, Timeline& out)
+        {
+            const float amount = juce::jlimit(0.5f, 0.75f, swing) - 0.5f;
+            std::copy(pattern.locks.begin(), pattern.locks.begin() + pattern.numLocks, out.locks.begin());
+            
+            int spare = MAX_EVENTS;
+            for (int voice = 0; voice < NUM_VOICES; ++voice)
+                spare -= StepMask::count(pattern.getSteps(voice) & StepMask::firstSteps(pattern.getLength(voice)));
+            
+            int numEvents = 0;
+            for (int voice = 0; voice < NUM_VOICES; ++voice)
+            {
+                auto& track = out.tracks[static_cast<size_t>(voice)];
+                const int length = pattern.getLength(voice);
+                const int stepTicks = ticksPerStep(pattern.getRate(voice));
+                const int swingTicks = juce::roundToInt(amount * 2.0f * static_cast<float>(stepTicks));
+                const auto accents = pattern.getAccents(voice);
+                const auto stepStart = [&](int step) { return step * stepTicks + ((step & 1) != 0 ? swingTicks : 0); };
+                
+                track.firstEvent = numEvents;
+                track.lengthTicks = length * stepTicks;
+                for (auto bits = pattern.getSteps(voice) & StepMask::firstSteps(length); bits != 0; bits &= bits - 1)
+                {
+                    const int step = StepMask::lowest(bits);
+                    const int nudge = juce::roundToInt(pattern.microTiming[static_cast<size_t>(voice)][static_cast<size_t>(step)]
+                                                       * stepTicks / static_cast<float>(Pattern::MICRO_PER_STEP));
+                    const int tick = juce::jlimit(0, track.lengthTicks - 1, stepStart(step) + nudge);
+                    const int end = juce::jlimit(tick, track.lengthTicks, stepStart(step + 1) + nudge);
+                    const auto lockRange = pattern.findLocks(voice, step);
+                    const auto ratchet = pattern.getRatchet(voice, step);
+                    const int hits = ratchet.count - 1 <= spare ? ratchet.count : 1;
+                    spare -= hits - 1;
+                    
+                    Event event {tick, StepMask::test(accents, step) ? 1.0f : 0.8f, 0.0f,
+                        static_cast<std::uint16_t>(lockRange.first), static_cast<std::uint16_t>(lockRange.second - lockRange.first),
+                        pattern.getCondition(voice, step), static_cast<std::uint8_t>(pattern.getProbability(voice, step)),
+                        static_cast<std::uint8_t>(voice), static_cast<std::uint8_t>(step)};
+                    const float velocity = event.velocity;
+                    const float velocityRamp = ratchet.velocityRamp * 0.01f;
+                    for (int i = 0; i < hits; ++i)
+                    {
+                        const float t = hits > 1 ? static_cast<float>(i) / static_cast<float>(hits - 1) : 0.0f;
+                        event.tick = tick + (i * (end - tick) + hits / 2) / hits;
+                        event.velocity = velocity * (1.0f - std::abs(velocityRamp) * (velocityRamp > 0.0f ? 1.0f - t : t));
+                        event.transpose = ratchet.pitchRamp * t;
+                        out.events[static_cast<size_t>(numEvents++)] = event;
+                    }
+                }
+                track.numEvents = numEvents - track.firstEvent;
+                
+                // Nudged steps can pass their neighbours
+                std::stable_sort(out.events.begin() + track.firstEvent, out.events.begin() + numEvents,
+                                 [](const Event& a, const Event& b) { return a.tick < b.tick; });
+            }
+        }
+    };
     
-    void setBPM(double bpm) { currentBPM = bpm; }
-    double getBPM() const { return currentBPM; }
+    /**
+     * An arrangement of bank slots, each played for a number of bars. When it runs out
+     * it starts over, or stops the transport if loop is off. A chain is a looping song
+     * of single bars.
+     */
+    struct Song
+    {
+        static constexpr int MAX_ENTRIES = 256;
+        
+        struct Entry
+        {
+            int slot = 0;
+            int repeats = 1; // bars
+        };
+        
+        std::array<Entry, MAX_ENTRIES> entries{};
+        int numEntries = 0;
+        bool loop = true;
+        
+        void add(int slot, int repeats = 1)
+        {
+            if (numEntries < MAX_ENTRIES)
+                entries[static_cast<size_t>(numEntries++)] = {juce::jlimit(0, NUM_SLOTS - 1, slot), juce::jmax(1, repeats)};
+        }
+    };
+    
+    struct Command
+    {
+        enum Kind { Play, Stop, Locate, ChangePattern, FollowSong };
+        enum Timing { Now, NextStep, NextBar }; // Now = first sample of the next block
+        
+        Kind kind = Play;
+        Timing timing = Now;
+        int step = 0;       // Play (start step), Locate
+        int index = 0;      // ChangePattern (slot), FollowSong (entry)
+    };
+    
+    struct Position
+    {
+        int step = 0;           // step just played (or located to)
+        int64_t sampleTime = 0; // audio-thread sample clock, 0 at prepare()
+        bool playing = false;
+        int slot = 0;           // bank slot playing
+        int songEntry = -1;     // -1 when not following the song
+    };
+    
+    Sequencer()
+    {
+        // Every slot starts out empty, so one compile serves them all
+        Timeline::compile(patterns->front(), swing, scratch);
+        for (auto& slot : *slots)
+            slot.publish(scratch);
+        songs.publish(song);
+        activeTimeline = &slots->front().acquire();
+        activeSong = &songs.acquire();
+    }
+    
+    // Not real-time; resets the sample clock
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        samplesPerTick = 60.0 / bpm / 4.0 / TICKS_PER_STEP * sampleRate;
+        sampleTime = 0;
+    }
     
-    const Pattern& getPattern() const { return pattern; }
-    void setPattern(const Pattern& newPattern) { pattern = newPattern; }
+    // Message thread: edit the pattern in the edit slot, each call recompiles and publishes it
+    void setStep(int voice, int step, bool active) { editPattern().setStep(voice, step, active); publish(editSlot); }
+    void setStep(int voice, int step, bool active, bool accent) { editPattern().setStep(voice, step, active, accent); publish(editSlot); }
+    void setAccent(int voice, int step, bool accent) { editPattern().setAccent(voice, step, accent); publish(editSlot); }
+    bool getStep(int voice, int step) const { return getPattern().getStep(voice, step); }
+    bool getAccent(int voice, int step) const { return getPattern().getAccent(voice, step); }
     
-    // Generate MIDI data for drag & drop
+    const Pattern& getPattern() const { return (*patterns)[static_cast<size_t>(editSlot)]; }
+    const Pattern& getPattern(int slot) const { return (*patterns)[static_cast<size_t>(juce::jlimit(0, NUM_SLOTS - 1, slot))]; }
+    
+    // Message thread: which bank slot the edits above (and setPattern) go to; playback is separate
+    void setEditSlot(int slot) { editSlot = juce::jlimit(0, NUM_SLOTS - 1, slot); }
+    int getEditSlot() const { return editSlot; }
+    
+    // Message thread: parameter locks on the edit slot. false when the table is full
+    bool setLock(int voice, int step, int param, float value)
+    {
+        const bool stored = editPattern().setLock(voice, step, param, value);
+        publish(editSlot);
+        return stored;
+    }
+    void clearLock(int voice, int step, int param) { editPattern().clearLock(voice, step, param); publish(editSlot); }
+    void clearLocks(int voice, int step) { editPattern().clearLocks(voice, step); publish(editSlot); }
+    bool getLock(int voice, int step, int param, float& value) const { return getPattern().getLock(voice, step, param, value); }
+    
+    // Message thread: per-track length (1-64 steps) and clock
+    void setLength(int voice, int steps) { editPattern().setLength(voice, steps); publish(editSlot); }
+    void setRate(int voice, Rate rate) { editPattern().setRate(voice, rate); publish(editSlot); }
+    int getLength(int voice) const { return getPattern().getLength(voice); }
+    Rate getRate(int voice) const { return getPattern().getRate(voice); }
+    
+    // Message thread: trig condition and probability (0-100 %) of a step in the edit slot
+    void setCondition(int voice, int step, Condition condition) { editPattern().setCondition(voice, step, condition); publish(editSlot); }
+    void setProbability(int voice, int step, int percent) { editPattern().setProbability(voice, step, percent); publish(editSlot); }
+    Condition getCondition(int voice, int step) const { return getPattern().getCondition(voice, step); }
+    int getProbability(int voice, int step) const { return getPattern().getProbability(voice, step); }
+    
+    // Message thread: play a step of the edit slot as a roll (see Pattern::setRatchet)
+    void setRatchet(int voice, int step, int count, int velocityRamp = 0, int pitchRamp = 0)
+    {
+        editPattern().setRatchet(voice, step, count, velocityRamp, pitchRamp);
+        publish(editSlot);
+    }
+    Ratchet getRatchet(int voice, int step) const { return getPattern().getRatchet(voice, step); }
+    
+    // Message thread: nudge a step of the edit slot, -0.5 to 0.5 track steps
+    void setMicroTiming(int voice, int step, float steps) { editPattern().setMicroTiming(voice, step, steps); publish(editSlot); }
+    float getMicroTiming(int voice, int step) const { return getPattern().getMicroTiming(voice, step); }
+    
+    /**
+     * Any thread: humanisation of every hit, timing spread in ms either side (a hit never
+     * leaves its transport step) and velocity spread as a share of the velocity, 0-1.
+     * GenreConfig has a pair per genre.
+     */
+    void setHumanize(float timingMs, float velocityAmount)
+    {
+        humanizeTiming = juce::jmax(0.0f, timingMs);
+        humanizeVelocity = juce::jlimit(0.0f, 1.0f, velocityAmount);
+    }
+    
+    // Any thread: how much of that humanisation plays, 0 (on the grid) to 1
+    void setHumanizeAmount(float amount) { humanizeAmount = juce::jlimit(0.0f, 1.0f, amount); }
+    
+    // Any thread: seed for probability and humanisation, taken on the next play
+    void setSeed(std::uint32_t newSeed) { seed = newSeed; }
+    
+    // Any thread: fill mode, for Fill / NotFill conditions, while held
+    void setFill(bool active) { fill = active; }
+    bool getFill() const { return fill.load(); }
+    
+    // Message thread: 0 or 0.5 (straight) to 0.75, for every slot
+    void setSwing(float newSwing)
+    {
+        swing = newSwing;
+        for (int slot = 0; slot < NUM_SLOTS; ++slot)
+            publish(slot);
+    }
+    float getSwing() const { return swing; }
+    
+    // Message thread: replace the whole pattern in the edit slot. A quantised change also
+    // switches playback to that slot on the boundary, and holds back every later edit of
+    // the playing slot until then
+    void setPattern(const Pattern& newPattern, Command::Timing timing = Command::Now)
+    {
+        // The command goes first: a block running in between must already see the change
+        // queued, or it would take the new timeline mid-bar
+        if (timing != Command::Now)
+            selectPattern(editSlot, timing);
+        editPattern() = newPattern;
+        publish(editSlot);
+    }
+    
+    // Message thread: switch playback to a bank slot (leaves song mode)
+    void selectPattern(int slot, Command::Timing timing = Command::NextBar)
+    {
+        send({Command::ChangePattern, timing, 0, juce::jlimit(0, NUM_SLOTS - 1, slot)});
+    }
+    
+    // Message thread: the arrangement, and following it from an entry
+    void setSong(const Song& newSong) { song = newSong; songs.publish(song); }
+    const Song& getSong() const { return song; }
+    void followSong(int entry = 0, Command::Timing timing = Command::NextBar) { send({Command::FollowSong, timing, 0, entry}); }
+    
+    // Message thread: transport. The tempo is a value the audio thread picks up at the next
+    // block rather than a command, so any number of changes between blocks land on the last;
+    // BPM reads back the requested tempo, getPlaying() what the audio thread is doing
+    void play(int fromStep = 0, Command::Timing timing = Command::Now) { send({Command::Play, timing, fromStep}); }
+    void stop(Command::Timing timing = Command::Now) { send({Command::Stop, timing}); }
+    void locate(int step, Command::Timing timing = Command::NextStep) { send({Command::Locate, timing, step}); }
+    void setBPM(double bpm) { requestedBpm = juce::jlimit(20.0, 300.0, bpm); }
+    double getBPM() const { return requestedBpm.load(); }
+    bool getPlaying() const { return isPlaying.load(); }
+    
+    // Message thread: the next step report, oldest first; false when there is none
+    bool popPosition(Position& position) { return positions.pop(position); }
+    
+    /**
+     * Message thread: the bank, the song, tempo, swing and humanisation as a ValueTree for
+     * the plugin state. Only tracks and steps that differ from the defaults are written,
+     * and empty slots not at all, so an unused bank costs a few bytes.
+     */
+    juce::ValueTree getState() const
+    {
+        juce::ValueTree state("SEQUENCER");
+        state.setProperty("bpm", requestedBpm.load(), nullptr)
+             .setProperty("swing", swing, nullptr)
+             .setProperty("humanizeTiming", humanizeTiming.load(), nullptr)
+             .setProperty("humanizeVelocity", humanizeVelocity.load(), nullptr)
+             .setProperty("seed", static_cast<juce::int64>(seed.load()), nullptr)
+             .setProperty("editSlot", editSlot, nullptr);
+        
+        for (int slot = 0; slot < NUM_SLOTS; ++slot)
+        {
+            auto pattern = writePattern(getPattern(slot));
+            if (pattern.getNumChildren() > 0)
+                state.appendChild(pattern.setProperty("slot", slot, nullptr), nullptr);
+        }
+        
+        juce::ValueTree songState("SONG");
+        songState.setProperty("loop", song.loop, nullptr);
+        for (int i = 0; i < song.numEntries; ++i)
+        {
+            const auto& entry = song.entries[static_cast<size_t>(i)];
+            juce::ValueTree entryState("ENTRY");
+            songState.appendChild(entryState.setProperty("slot", entry.slot, nullptr)
+                                            .setProperty("repeats", entry.repeats, nullptr), nullptr);
+        }
+        state.appendChild(songState, nullptr);
+        return state;
+    }
+    
+    // Message thread: replaces everything getState() writes; slots missing from the state
+    // are emptied. Playback carries on, with the new patterns from the next block
+    void setState(const juce::ValueTree& state)
+    {
+        if (!state.hasType("SEQUENCER"))
+            return;
+        
+        for (auto& pattern : *patterns)
+            pattern = Pattern{};
+        for (const auto& child : state)
+        {
+            const int slot = child.getProperty("slot", -1);
+            if (child.hasType("PATTERN") && slot >= 0 && slot < NUM_SLOTS)
+                readPattern(child, (*patterns)[static_cast<size_t>(slot)]);
+        }
+        
+        // Publishes every slot
+        setSwing(state.getProperty("swing", 0.0f));
+        setHumanize(state.getProperty("humanizeTiming", 0.0f), state.getProperty("humanizeVelocity", 0.0f));
+        setSeed(static_cast<std::uint32_t>(static_cast<juce::int64>(state.getProperty("seed", 0))));
+        setEditSlot(state.getProperty("editSlot", 0));
+        
+        Song restored;
+        const auto songState = state.getChildWithName("SONG");
+        restored.loop = songState.getProperty("loop", true);
+        for (const auto& entry : songState)
+            restored.add(entry.getProperty("slot", 0), entry.getProperty("repeats", 1));
+        setSong(restored);
+        
+        setBPM(state.getProperty("bpm", 120.0));
+    }
+    
+    /**
+     * Audio thread: runs the transport over one block. onTrigger(sampleOffset, trigger) is
+     * called for every hit that falls inside the block, in time order. The loop only
+     * visits events and transport step boundaries (for commands and position reports),
+     * picking the earliest of the 12 track cursors each time, so its cost is the number
+     * of those in the block, not the block length. A hit whose condition or probability
+     * fails is stepped over without a call.
+     */
+    template <typename TriggerCallback>
+    void process(int numSamples, TriggerCallback&& onTrigger)
+    {
+        activeSong = &songs.acquire();
+        const float humanize = humanizeAmount.load();
+        timingSpread = humanizeTiming.load() * humanize * 0.001 * sampleRate;
+        velocitySpread = humanizeVelocity.load() * humanize;
+        fillActive = fill.load();
+        
+        const double newBpm = requestedBpm.load();
+        if (newBpm != bpm)
+            setTempo(newBpm, 0.0);
+        
+        Command command;
+        while (commands.pop(command))
+        {
+            if (command.timing == Command::Now || !isPlaying.load())
+                apply(command, 0.0);
+            else if (numQueued < queued.size())
+                queued[numQueued++] = command;
+        }
+        
+        if (!patternChangeQueued())
+        {
+            const auto* newest = &(*slots)[static_cast<size_t>(activeSlot)].acquire();
+            if (newest != activeTimeline)
+            {
+                // Hits the play position has already passed (a sample or more ago) are not played late
+                const auto passed = static_cast<int64_t>(std::floor(anchorTick - (anchorSample + 1.0) / samplesPerTick)) + 1;
+                activeTimeline = newest;
+                seekTracks(juce::jmax(cursorTick, passed));
+            }
+        }
+        
+        while (isPlaying.load())
+        {
+            // Next thing to happen: a step boundary wins a tie with the hits on it,
+            // tracks sharing a time go in voice order
+            int voice = -1;
+            int64_t eventTick = 0;
+            double eventTime = std::numeric_limits<double>::max();
+            for (int v = 0; v < NUM_VOICES; ++v)
+            {
+                const auto& track = activeTimeline->tracks[static_cast<size_t>(v)];
+                if (track.numEvents == 0)
+                    continue;
+                const int64_t t = trackStart[static_cast<size_t>(v)]
+                                + activeTimeline->event(v, trackNext[static_cast<size_t>(v)]).tick;
+                const double when = hitTime(v, t);
+                if (when < eventTime)
+                {
+                    eventTick = t;
+                    eventTime = when;
+                    voice = v;
+                }
+            }
+            
+            const int64_t boundaryTick = nextStep * TICKS_PER_STEP;
+            const double boundaryTime = timeAt(boundaryTick);
+            const bool atBoundary = boundaryTime <= eventTime;
+            const int64_t tick = atBoundary ? boundaryTick : eventTick;
+            const double time = atBoundary ? boundaryTime : eventTime;
+            const int offset = toOffset(time);
+            if (offset >= numSamples)
+                break;
+            
+            // The anchor stays on the tempo grid, humanised or not
+            anchorSample = timeAt(tick);
+            anchorTick = static_cast<double>(tick);
+            lastTime = time;
+            cursorTick = juce::jmax(cursorTick, tick + 1);
+            
+            if (atBoundary)
+            {
+                // The song moves on first, then quantised commands due on this boundary, in the
+                // order they were sent
+                const bool atBar = nextStep % NUM_STEPS == 0;
+                if (atBar)
+                    advanceSong(time);
+                applyQueued(time, atBar);
+                if (!isPlaying.load())
+                    break;
+                
+                report(static_cast<int>(nextStep % NUM_STEPS), offset, true); // dropped while nobody reads (editor closed)
+                ++nextStep;
+            }
+            else
+            {
+                const auto& track = activeTimeline->tracks[static_cast<size_t>(voice)];
+                auto& next = trackNext[static_cast<size_t>(voice)];
+                const auto& event = activeTimeline->event(voice, next);
+                const int64_t loopStart = trackStart[static_cast<size_t>(voice)];
+                if (++next == track.numEvents) // loop the track
+                {
+                    next = 0;
+                    trackStart[static_cast<size_t>(voice)] += track.lengthTicks;
+                }
+                
+                // The chance dice belong to the step, so a ratchet plays or sits out as a whole
+                if (passes(event, loopStart / track.lengthTicks, roll(voice, loopStart + event.step, 1)))
+                {
+                    const float velocity = juce::jlimit(0.0f, 1.0f, event.velocity
+                        * (1.0f + velocitySpread * static_cast<float>(2.0 * roll(voice, eventTick, 2) - 1.0)));
+                    const auto fraction = static_cast<float>(juce::jlimit(0.0, 0.999999, offset - time));
+                    onTrigger(offset, Trigger { event.voice, velocity, activeTimeline->locks.data() + event.firstLock,
+                                                event.numLocks, event.transpose, fraction });
+                }
+            }
+        }
+        
+        anchorSample -= numSamples;
+        lastTime -= numSamples;
+        sampleTime += numSamples;
+    }
+    
+    // Generate MIDI data for drag & drop: one transport bar, shorter tracks looped
     juce::MidiFile generateMidiFile() const
     {
         juce::MidiFile midiFile;
@@ -91,19 +919,31 @@ public:
         // GM Drum Map
         const int noteMap[NUM_VOICES] = {36, 38, 41, 47, 50, 37, 39, 42, 46, 49, 51, 56};
         
-        double ticksPerStep = 960.0 / 4.0; // 16th notes
+        const double midiTicksPerTick = 960.0 / 4.0 / TICKS_PER_STEP; // 16th notes
         
+        Timeline timeline;
+        Timeline::compile(getPattern(), swing, timeline);
         for (int voice = 0; voice < NUM_VOICES; ++voice)
         {
-            for (int step = 0; step < NUM_STEPS; ++step)
+            const auto& source = timeline.tracks[static_cast<size_t>(voice)];
+            const int stepTicks = ticksPerStep(getPattern().getRate(voice));
+            for (int start = 0; source.numEvents > 0 && start < NUM_STEPS * TICKS_PER_STEP; start += source.lengthTicks)
             {
-                if (pattern.getStep(voice, step))
+                for (int i = 0; i < source.numEvents; ++i)
                 {
-                    double timestamp = step * ticksPerStep;
+                    const auto& event = timeline.event(voice, i);
+                    if (start + event.tick >= NUM_STEPS * TICKS_PER_STEP)
+                        break;
+                    
+                    // Notes end before the next hit of the voice (ratchets)
+                    const int nextTick = i + 1 < source.numEvents ? timeline.event(voice, i + 1).tick
+                                                                  : source.lengthTicks + timeline.event(voice, 0).tick;
+                    const double noteLength = juce::jmin(stepTicks, nextTick - event.tick) * 0.9 * midiTicksPerTick;
+                    double timestamp = (start + event.tick) * midiTicksPerTick;
                     int note = noteMap[voice];
                     
-                    track.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8)100), timestamp);
-                    track.addEvent(juce::MidiMessage::noteOff(1, note), timestamp + ticksPerStep * 0.9);
+                    track.addEvent(juce::MidiMessage::noteOn(1, note, event.velocity), timestamp);
+                    track.addEvent(juce::MidiMessage::noteOff(1, note), timestamp + noteLength);
                 }
             }
         }
@@ -115,8 +955,344 @@ public:
     }
     
 private:
-    Pattern pattern;
-    int currentStep = 0;
-    bool isPlaying = false;
-    double currentBPM = 120.0;
+    Pattern& editPattern() { return (*patterns)[static_cast<size_t>(editSlot)]; }
+    
+    // A TRACK for each voice with anything to keep: masks, length and rate, then a STEP
+    // for each step with trig settings and a LOCK for each lock
+    static juce::ValueTree writePattern(const Pattern& pattern)
+    {
+        juce::ValueTree state("PATTERN");
+        for (int voice = 0; voice < NUM_VOICES; ++voice)
+        {
+            juce::ValueTree track("TRACK");
+            for (int step = 0; step < StepMask::MAX_STEPS; ++step)
+            {
+                const auto condition = pattern.getCondition(voice, step);
+                const auto ratchet = pattern.getRatchet(voice, step);
+                const int probability = pattern.getProbability(voice, step);
+                const float micro = pattern.getMicroTiming(voice, step);
+                if (condition.kind == Condition::Always && probability == 100 && ratchet.count == 1 && micro == 0.0f)
+                    continue;
+                
+                juce::ValueTree stepState("STEP");
+                track.appendChild(stepState.setProperty("step", step, nullptr)
+                                           .setProperty("condition", static_cast<int>(condition.kind), nullptr)
+                                           .setProperty("a", condition.a, nullptr)
+                                           .setProperty("b", condition.b, nullptr)
+                                           .setProperty("probability", probability, nullptr)
+                                           .setProperty("ratchet", ratchet.count, nullptr)
+                                           .setProperty("velocityRamp", ratchet.velocityRamp, nullptr)
+                                           .setProperty("pitchRamp", ratchet.pitchRamp, nullptr)
+                                           .setProperty("microTiming", micro, nullptr), nullptr);
+            }
+            for (int i = 0; i < pattern.numLocks; ++i)
+            {
+                const auto& lock = pattern.locks[static_cast<size_t>(i)];
+                if (lock.key / StepMask::MAX_STEPS != voice)
+                    continue;
+                juce::ValueTree lockState("LOCK");
+                track.appendChild(lockState.setProperty("step", lock.key % StepMask::MAX_STEPS, nullptr)
+                                           .setProperty("param", lock.param, nullptr)
+                                           .setProperty("value", lock.value, nullptr), nullptr);
+            }
+            
+            const auto steps = pattern.getSteps(voice), accents = pattern.getAccents(voice);
+            if (steps == 0 && accents == 0 && pattern.getLength(voice) == NUM_STEPS
+                && pattern.getRate(voice) == Sixteenth && track.getNumChildren() == 0)
+                continue;
+            state.appendChild(track.setProperty("voice", voice, nullptr)
+                                   .setProperty("steps", static_cast<juce::int64>(steps), nullptr)
+                                   .setProperty("accents", static_cast<juce::int64>(accents), nullptr)
+                                   .setProperty("length", pattern.getLength(voice), nullptr)
+                                   .setProperty("rate", static_cast<int>(pattern.getRate(voice)), nullptr), nullptr);
+        }
+        return state;
+    }
+    
+    // Into an empty pattern; the setters range-check every value
+    static void readPattern(const juce::ValueTree& state, Pattern& pattern)
+    {
+        for (const auto& track : state)
+        {
+            const int voice = track.getProperty("voice", -1);
+            if (!track.hasType("TRACK") || voice < 0 || voice >= NUM_VOICES)
+                continue;
+            
+            pattern.setSteps(voice, static_cast<std::uint64_t>(static_cast<juce::int64>(track.getProperty("steps", 0))),
+                             static_cast<std::uint64_t>(static_cast<juce::int64>(track.getProperty("accents", 0))));
+            pattern.setLength(voice, track.getProperty("length", NUM_STEPS));
+            pattern.setRate(voice, static_cast<Rate>(juce::jlimit(0, static_cast<int>(Quarter),
+                                                                  static_cast<int>(track.getProperty("rate", Sixteenth)))));
+            for (const auto& child : track)
+            {
+                const int step = child.getProperty("step", -1);
+                if (child.hasType("STEP"))
+                {
+                    const int kind = juce::jlimit(0, static_cast<int>(Condition::First), static_cast<int>(child.getProperty("condition", 0)));
+                    pattern.setCondition(voice, step, kind == Condition::Ratio
+                        ? Condition::ratio(child.getProperty("a", 1), child.getProperty("b", 1))
+                        : Condition{static_cast<Condition::Kind>(kind)});
+                    pattern.setProbability(voice, step, child.getProperty("probability", 100));
+                    pattern.setRatchet(voice, step, child.getProperty("ratchet", 1), child.getProperty("velocityRamp", 0),
+                                       child.getProperty("pitchRamp", 0));
+                    pattern.setMicroTiming(voice, step, child.getProperty("microTiming", 0.0f));
+                }
+                else if (child.hasType("LOCK"))
+                {
+                    pattern.setLock(voice, step, child.getProperty("param", 0), child.getProperty("value", 0.0f));
+                }
+            }
+        }
+    }
+    
+    void publish(int slot)
+    {
+        Timeline::compile((*patterns)[static_cast<size_t>(slot)], swing, scratch);
+        (*slots)[static_cast<size_t>(slot)].publish(scratch);
+    }
+    
+    void send(const Command& command)
+    {
+        const bool sent = commands.push(command);
+        jassert(sent); // 64 commands between two audio blocks
+        juce::ignoreUnused(sent);
+    }
+    
+    bool patternChangeQueued() const
+    {
+        for (size_t i = 0; i < numQueued; ++i)
+            if (queued[i].kind == Command::ChangePattern)
+                return true;
+        return false;
+    }
+    
+    // First whole sample at or after a fractional block position
+    static int toOffset(double time) { return juce::jmax(0, static_cast<int>(std::ceil(time - 1.0e-6))); }
+    
+    // Block position of a tick on the tempo grid
+    double timeAt(int64_t tick) const { return anchorSample + (static_cast<double>(tick) - anchorTick) * samplesPerTick; }
+    
+    /**
+     * Block position of a voice's hit, humanised: spread either side of the grid, but kept
+     * inside its transport step (so boundary commands and reports stay on the right side
+     * of it) and not before the last thing played (so hits still come out in order).
+     */
+    double hitTime(int voice, int64_t tick) const
+    {
+        const double time = timeAt(tick);
+        if (timingSpread <= 0.0)
+            return time;
+        const int64_t stepTick = tick - tick % TICKS_PER_STEP;
+        const double earliest = juce::jmax(timeAt(stepTick), lastTime);
+        const double latest = juce::jmax(earliest, timeAt(stepTick + TICKS_PER_STEP) - 1.0);
+        return juce::jlimit(earliest, latest, time + (2.0 * roll(voice, tick, 0) - 1.0) * timingSpread);
+    }
+    
+    // Counter-based RNG (SplitMix64 finaliser): uniform in [0, 1), fixed by the seed, the
+    // play epoch, the voice, a tick (for chance, the step's place in its loop) and which
+    // dice (timing, chance, velocity)
+    static std::uint64_t mix(std::uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+    
+    double roll(int voice, int64_t tick, int dice) const
+    {
+        const auto key = static_cast<std::uint64_t>(tick) << 6 | static_cast<std::uint64_t>(voice << 2 | dice);
+        const auto stream = static_cast<std::uint64_t>(playSeed) << 32 | epoch;
+        return static_cast<double>(mix(mix(stream) ^ key) >> 11) * 0x1.0p-53;
+    }
+    
+    // Whether a hit plays this time round; loop counts the track's loops since it started
+    bool passes(const Event& event, int64_t loop, double chance) const
+    {
+        switch (event.condition.kind)
+        {
+            case Condition::Always:  break;
+            case Condition::Ratio:   if (loop % event.condition.b != event.condition.a - 1) return false; break;
+            case Condition::Fill:    if (!fillActive) return false; break;
+            case Condition::NotFill: if (fillActive) return false; break;
+            case Condition::First:   if (loop != 0) return false; break;
+        }
+        return chance * 100.0 < event.probability;
+    }
+    
+    void applyQueued(double time, bool atBar)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < numQueued; ++i)
+        {
+            if (queued[i].timing == Command::NextStep || atBar)
+                apply(queued[i], time);
+            else
+                queued[kept++] = queued[i];
+        }
+        numQueued = kept;
+    }
+    
+    void report(int step, int offset, bool playing)
+    {
+        positions.push({step, sampleTime + offset, playing, activeSlot, songEntry});
+    }
+    
+    // Moves the play position to the start of a transport step, at the given block position.
+    // Tracks restart in phase, as if played from the top of the bar
+    void seekStep(int step, double time)
+    {
+        nextStep = juce::jlimit(0, NUM_STEPS - 1, step);
+        anchorTick = static_cast<double>(nextStep * TICKS_PER_STEP);
+        anchorSample = time;
+        lastTime = time;
+        cursorTick = nextStep * TICKS_PER_STEP;
+        ++epoch;
+        seekTracks(cursorTick);
+    }
+    
+    // Points every track cursor at its first hit at or after tick
+    void seekTracks(int64_t tick)
+    {
+        for (size_t v = 0; v < activeTimeline->tracks.size(); ++v)
+        {
+            const auto& track = activeTimeline->tracks[v];
+            trackStart[v] = tick - tick % track.lengthTicks;
+            trackNext[v] = activeTimeline->seek(static_cast<int>(v), static_cast<int>(tick - trackStart[v]));
+            if (trackNext[v] == track.numEvents)
+            {
+                trackStart[v] += track.lengthTicks;
+                trackNext[v] = 0;
+            }
+        }
+    }
+    
+    // Takes the newest version of a slot; its tracks start in phase from the top of this bar
+    void switchSlot(int slot)
+    {
+        const int64_t barStart = (nextStep - nextStep % NUM_STEPS) * TICKS_PER_STEP;
+        nextStep %= NUM_STEPS;
+        anchorTick -= static_cast<double>(barStart);
+        activeSlot = slot;
+        activeTimeline = &(*slots)[static_cast<size_t>(slot)].acquire();
+        seekTracks(nextStep * TICKS_PER_STEP);
+        cursorTick = nextStep * TICKS_PER_STEP;
+        ++epoch;
+    }
+    
+    void startSongEntry(int entry)
+    {
+        if (activeSong->numEntries == 0)
+        {
+            songEntry = -1;
+            return;
+        }
+        songEntry = juce::jlimit(0, activeSong->numEntries - 1, entry);
+        const auto& e = activeSong->entries[static_cast<size_t>(songEntry)];
+        barsLeft = e.repeats;
+        switchSlot(e.slot);
+    }
+    
+    // On a bar boundary: counts the bar that just ended against the song entry
+    void advanceSong(double time)
+    {
+        if (songEntry < 0 || nextStep == 0 || --barsLeft > 0)
+            return;
+        
+        if (songEntry + 1 < activeSong->numEntries)
+            startSongEntry(songEntry + 1);
+        else if (activeSong->loop)
+            startSongEntry(0);
+        else
+        {
+            songEntry = -1;
+            isPlaying = false;
+            numQueued = 0;
+            report(0, toOffset(time), false);
+        }
+    }
+    
+    // Re-anchors at the current position so the tempo changes from here on
+    void setTempo(double newBpm, double time)
+    {
+        anchorTick += (time - anchorSample) / samplesPerTick;
+        anchorSample = time;
+        bpm = newBpm;
+        samplesPerTick = 60.0 / bpm / 4.0 / TICKS_PER_STEP * sampleRate;
+    }
+    
+    void apply(const Command& command, double time)
+    {
+        switch (command.kind)
+        {
+            case Command::Play:
+                seekStep(command.step, time);
+                playSeed = seed.load();
+                epoch = 0; // a render from the top rolls the same dice every time
+                isPlaying = true;
+                break;
+            case Command::Stop:
+                isPlaying = false;
+                numQueued = 0;
+                report(static_cast<int>(nextStep % NUM_STEPS), toOffset(time), false);
+                break;
+            case Command::Locate:
+                seekStep(command.step, time);
+                if (!isPlaying.load())
+                    report(static_cast<int>(nextStep), toOffset(time), false);
+                break;
+            case Command::ChangePattern:
+                songEntry = -1;
+                switchSlot(command.index);
+                break;
+            case Command::FollowSong:
+                startSongEntry(command.index);
+                break;
+        }
+    }
+    
+    // The bank is megabytes (three compiled timelines per slot), so it lives on the heap,
+    // allocated once with the sequencer
+    
+    // Message thread
+    std::unique_ptr<std::array<Pattern, NUM_SLOTS>> patterns = std::make_unique<std::array<Pattern, NUM_SLOTS>>(); // the editor's copies
+    int editSlot = 0;
+    Song song;
+    Timeline scratch;
+    float swing = 0.0f;
+    
+    // Shared
+    std::unique_ptr<std::array<TripleBuffer<Timeline>, NUM_SLOTS>> slots
+        = std::make_unique<std::array<TripleBuffer<Timeline>, NUM_SLOTS>>(); // all compiled up front, switched by index
+    TripleBuffer<Song> songs;
+    SpscQueue<Command, 64> commands; // discrete transport and pattern commands only
+    std::atomic<double> requestedBpm { 120.0 };
+    SpscQueue<Position, 256> positions;
+    std::atomic<bool> isPlaying { false };
+    std::atomic<float> humanizeTiming { 0.0f }, humanizeVelocity { 0.0f }, humanizeAmount { 1.0f };
+    std::atomic<std::uint32_t> seed { 0 };
+    std::atomic<bool> fill { false };
+    
+    // Audio thread. Ticks count from the last play / locate / pattern change. The play
+    // position is anchored: tick anchorTick (fractional after a tempo change) falls at
+    // sample anchorSample of the current block
+    const Timeline* activeTimeline = nullptr;
+    const Song* activeSong = nullptr;
+    int activeSlot = 0;
+    int songEntry = -1, barsLeft = 0;
+    std::array<Command, 64> queued{};
+    size_t numQueued = 0;
+    double sampleRate = 44100.0, bpm = 120.0;
+    double samplesPerTick = 60.0 / 120.0 / 4.0 / TICKS_PER_STEP * 44100.0;
+    double anchorTick = 0.0, anchorSample = 0.0;
+    int64_t cursorTick = 0; // first tick not yet played
+    int64_t nextStep = 0;   // transport step whose boundary comes next, counting past the bar
+    std::array<int64_t, NUM_VOICES> trackStart{}; // tick where each track's current loop began
+    std::array<int, NUM_VOICES> trackNext{};      // index of each track's next event
+    int64_t sampleTime = 0;
+    double lastTime = 0.0; // block position of the last boundary or hit played
+    std::uint32_t playSeed = 0, epoch = 0; // epoch counts restarts since play, each rolls new dice
+    double timingSpread = 0.0; // samples, this block
+    float velocitySpread = 0.0f;
+    bool fillActive = false;
 };
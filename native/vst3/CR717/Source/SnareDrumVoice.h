@@ -29,14 +29,19 @@ public:
         lastRes = -1.0f;
     }
 
-    void trigger(float velocity) override
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        phase1 = 0.0f;
-        phase2 = 0.0f;
-        env = velocity;
-        noiseEnv = velocity;
-        active = true;
         updateSmoothedValues();
+        
+        // Start fraction samples in
+        const float elapsed = fraction / static_cast<float>(sampleRate);
+        const float tuneMult = tuneMultiplier(tune.getCurrentValue() + fineTune.getCurrentValue());
+        const float decayScale = std::pow(decayMultiplier(decay.getCurrentValue()), fraction);
+        phase1 = 180.0f * tuneMult * elapsed;
+        phase2 = 330.0f * tuneMult * elapsed;
+        env = velocity * std::exp(-elapsed / BODY_DECAY_TIME) * decayScale;
+        noiseEnv = velocity * std::exp(-elapsed / NOISE_DECAY_TIME) * decayScale;
+        active = true;
     }
 
     bool isActive() const override { return active && (env > 0.0001f || noiseEnv > 0.0001f); }
@@ -59,9 +64,9 @@ public:
             float currentTune = tune.getNextValue() + fineTune.getNextValue();
 
             // TR-808 spec: Dual resonators at 180 Hz and 330 Hz
-            float tuneMultiplier = std::pow(2.0f, currentTune / 12.0f);
-            float freq1 = (180.0f * tuneMultiplier) / static_cast<float>(sampleRate);
-            float freq2 = (330.0f * tuneMultiplier) / static_cast<float>(sampleRate);
+            float tuneMult = tuneMultiplier(currentTune);
+            float freq1 = (180.0f * tuneMult) / static_cast<float>(sampleRate);
+            float freq2 = (330.0f * tuneMult) / static_cast<float>(sampleRate);
             
             float body1 = std::sin(phase1 * juce::MathConstants<float>::twoPi) * env * 0.5f;
             float body2 = std::sin(phase2 * juce::MathConstants<float>::twoPi) * env * 0.3f;
@@ -95,18 +100,24 @@ public:
                 sample = postFilter.processSample(0, sample);
             }
 
-            // Body decay: 250ms, Noise decay: 200ms
-            float bodyDecayRate = std::exp(-1.0f / (0.25f * static_cast<float>(sampleRate)));
-            float noiseDecayRate = std::exp(-1.0f / (0.20f * static_cast<float>(sampleRate)));
+            float bodyDecayRate = std::exp(-1.0f / (BODY_DECAY_TIME * static_cast<float>(sampleRate)));
+            float noiseDecayRate = std::exp(-1.0f / (NOISE_DECAY_TIME * static_cast<float>(sampleRate)));
             
-            env *= bodyDecayRate * (0.95f + currentDecay * 0.05f);
-            noiseEnv *= noiseDecayRate * (0.95f + currentDecay * 0.05f);
+            env *= bodyDecayRate * decayMultiplier(currentDecay);
+            noiseEnv *= noiseDecayRate * decayMultiplier(currentDecay);
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    static float tuneMultiplier(float tuneSemitones) { return std::pow(2.0f, tuneSemitones / 12.0f); }
+
+    // Body decay: 250ms, Noise decay: 200ms, both shortened per sample by the decay setting
+    static constexpr float BODY_DECAY_TIME = 0.25f;
+    static constexpr float NOISE_DECAY_TIME = 0.20f;
+    static float decayMultiplier(float decaySetting) { return 0.95f + decaySetting * 0.05f; }
+
     float phase1 = 0.0f;
     float phase2 = 0.0f;
     float env = 0.0f;
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * One sequencer track packed into a 64-bit word, bit n = step n. Whole-track edits
+ * (rotate, invert, Euclidean fill, merge, density) are a handful of word operations
+ * instead of a loop over steps. Functions that take a length only touch, and only
+ * return, the first `length` steps.
+ */
+namespace StepMask
+{
+    static constexpr int MAX_STEPS = 64;
+
+    // Bits 0 .. length-1
+    inline std::uint64_t firstSteps(int length)
+    {
+        return length >= MAX_STEPS ? ~std::uint64_t{0} : (std::uint64_t{1} << juce::jmax(0, length)) - 1;
+    }
+
+    inline bool test(std::uint64_t bits, int step) { return ((bits >> step) & 1u) != 0; }
+
+    inline int count(std::uint64_t bits) { return juce::countNumberOfBits(static_cast<juce::uint64>(bits)); }
+
+    // Index of the lowest set bit; bits must not be 0
+    inline int lowest(std::uint64_t bits) { return count((bits & (~bits + 1)) - 1); }
+
+    // Positive amounts move steps later, wrapping at length
+    inline std::uint64_t rotate(std::uint64_t bits, int amount, int length)
+    {
+        length = juce::jlimit(1, MAX_STEPS, length);
+        const auto mask = firstSteps(length);
+        bits &= mask;
+        const int shift = ((amount % length) + length) % length;
+        if (shift == 0)
+            return bits;
+        return ((bits << shift) | (bits >> (length - shift))) & mask;
+    }
+
+    inline std::uint64_t invert(std::uint64_t bits, int length) { return ~bits & firstSteps(length); }
+
+    /**
+     * hits spread as evenly as possible over length steps, starting on step 0 before
+     * rotation: E(3, 8) is x..x..x., the tresillo. Same rhythms as Bjorklund's
+     * algorithm up to rotation.
+     */
+    inline std::uint64_t euclidean(int hits, int length, int rotation = 0)
+    {
+        length = juce::jlimit(1, MAX_STEPS, length);
+        hits = juce::jlimit(0, length, hits);
+        std::uint64_t bits = 0;
+        for (int step = 0; step < length; ++step)
+            if ((step * hits) % length < hits)
+                bits |= std::uint64_t{1} << step;
+        return rotate(bits, rotation, length);
+    }
+
+    template <size_t N>
+    std::uint64_t fromArray(const std::array<bool, N>& steps)
+    {
+        static_assert(N <= MAX_STEPS, "at most 64 steps per word");
+        std::uint64_t bits = 0;
+        for (size_t step = 0; step < N; ++step)
+            if (steps[step])
+                bits |= std::uint64_t{1} << step;
+        return bits;
+    }
+
+    template <size_t N>
+    std::array<bool, N> toArray(std::uint64_t bits)
+    {
+        static_assert(N <= MAX_STEPS, "at most 64 steps per word");
+        std::array<bool, N> steps{};
+        for (size_t step = 0; step < N; ++step)
+            steps[step] = test(bits, static_cast<int>(step));
+        return steps;
+    }
+}
@@ -15,13 +15,16 @@ public:
         pan.reset(sr, 0.02);
     }
 
-    void trigger(float velocity) override
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        phase = 0.0f;
-        env = velocity;
-        pitchEnvTime = 0.0f;
-        active = true;
         updateSmoothedValues();
+        
+        // Start fraction samples in, on the pitch bend's peak
+        const float elapsed = fraction / static_cast<float>(sampleRate);
+        phase = frequency(tune.getCurrentValue() + fineTune.getCurrentValue(), 0.0f) * elapsed;
+        env = velocity * std::exp(-elapsed / decayTime(decay.getCurrentValue()));
+        pitchEnvTime = elapsed;
+        active = true;
     }
 
     bool isActive() const override { return active && env > 0.0001f; }
@@ -34,28 +37,35 @@ public:
         {
             if (env <= 0.0001f) { active = false; break; }
             
-            // TR-808 spec: 130 Hz with pitch bend (10-20ms downward)
             pitchEnvTime += 1.0f / static_cast<float>(sampleRate);
-            float pitchBend = (pitchEnvTime < 0.015f) ? (1.0f + 0.05f * std::exp(-pitchEnvTime / 0.005f)) : 1.0f;
-            
             float currentTune = tune.getNextValue() + fineTune.getNextValue();
-            float baseFreq = 130.0f * std::pow(2.0f, currentTune / 12.0f);
-            float freq = (baseFreq * pitchBend) / static_cast<float>(sampleRate);
+            float freq = frequency(currentTune, pitchEnvTime) / static_cast<float>(sampleRate);
             
             float sample = std::sin(phase * juce::MathConstants<float>::twoPi) * env * level.getNextValue();
             phase += freq;
             if (phase >= 1.0f) phase -= 1.0f;
             
-            // Expo decay: 300ms
-            float decayTime = 0.3f * (0.5f + decay.getNextValue() * 0.5f);
-            float decayRate = std::exp(-1.0f / (decayTime * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate(decay.getNextValue());
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // TR-808 spec: 130 Hz with pitch bend (10-20ms downward)
+    static float frequency(float tuneSemitones, float time)
+    {
+        float pitchBend = (time < 0.015f) ? (1.0f + 0.05f * std::exp(-time / 0.005f)) : 1.0f;
+        return 130.0f * std::pow(2.0f, tuneSemitones / 12.0f) * pitchBend;
+    }
+
+    // Expo decay: 300ms
+    static float decayTime(float decaySetting) { return 0.3f * (0.5f + decaySetting * 0.5f); }
+    float decayRate(float decaySetting) const
+    {
+        return std::exp(-1.0f / (decayTime(decaySetting) * static_cast<float>(sampleRate)));
+    }
+
     float phase = 0.0f, env = 0.0f, pitchEnvTime = 0.0f;
     bool active = false;
 };
@@ -73,13 +83,16 @@ public:
         pan.reset(sr, 0.02);
     }
 
-    void trigger(float velocity) override
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        phase = 0.0f;
-        env = velocity;
-        pitchEnvTime = 0.0f;
-        active = true;
         updateSmoothedValues();
+        
+        // Start fraction samples in, on the pitch bend's peak
+        const float elapsed = fraction / static_cast<float>(sampleRate);
+        phase = frequency(tune.getCurrentValue() + fineTune.getCurrentValue(), 0.0f) * elapsed;
+        env = velocity * std::exp(-elapsed / decayTime(decay.getCurrentValue()));
+        pitchEnvTime = elapsed;
+        active = true;
     }
 
     bool isActive() const override { return active && env > 0.0001f; }
@@ -92,28 +105,35 @@ public:
         {
             if (env <= 0.0001f) { active = false; break; }
             
-            // TR-808 spec: 200 Hz with pitch bend (10-20ms downward)
             pitchEnvTime += 1.0f / static_cast<float>(sampleRate);
-            float pitchBend = (pitchEnvTime < 0.015f) ? (1.0f + 0.05f * std::exp(-pitchEnvTime / 0.005f)) : 1.0f;
-            
             float currentTune = tune.getNextValue() + fineTune.getNextValue();
-            float baseFreq = 200.0f * std::pow(2.0f, currentTune / 12.0f);
-            float freq = (baseFreq * pitchBend) / static_cast<float>(sampleRate);
+            float freq = frequency(currentTune, pitchEnvTime) / static_cast<float>(sampleRate);
             
             float sample = std::sin(phase * juce::MathConstants<float>::twoPi) * env * level.getNextValue();
             phase += freq;
             if (phase >= 1.0f) phase -= 1.0f;
             
-            // Expo decay: 280ms
-            float decayTime = 0.28f * (0.5f + decay.getNextValue() * 0.5f);
-            float decayRate = std::exp(-1.0f / (decayTime * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate(decay.getNextValue());
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // TR-808 spec: 200 Hz with pitch bend (10-20ms downward)
+    static float frequency(float tuneSemitones, float time)
+    {
+        float pitchBend = (time < 0.015f) ? (1.0f + 0.05f * std::exp(-time / 0.005f)) : 1.0f;
+        return 200.0f * std::pow(2.0f, tuneSemitones / 12.0f) * pitchBend;
+    }
+
+    // Expo decay: 280ms
+    static float decayTime(float decaySetting) { return 0.28f * (0.5f + decaySetting * 0.5f); }
+    float decayRate(float decaySetting) const
+    {
+        return std::exp(-1.0f / (decayTime(decaySetting) * static_cast<float>(sampleRate)));
+    }
+
     float phase = 0.0f, env = 0.0f, pitchEnvTime = 0.0f;
     bool active = false;
 };
@@ -131,13 +151,16 @@ public:
         pan.reset(sr, 0.02);
     }
 
-    void trigger(float velocity) override
+    void trigger(float velocity, float fraction = 0.0f) override
     {
-        phase = 0.0f;
-        env = velocity;
-        pitchEnvTime = 0.0f;
-        active = true;
         updateSmoothedValues();
+        
+        // Start fraction samples in, on the pitch bend's peak
+        const float elapsed = fraction / static_cast<float>(sampleRate);
+        phase = frequency(tune.getCurrentValue() + fineTune.getCurrentValue(), 0.0f) * elapsed;
+        env = velocity * std::exp(-elapsed / decayTime(decay.getCurrentValue()));
+        pitchEnvTime = elapsed;
+        active = true;
     }
 
     bool isActive() const override { return active && env > 0.0001f; }
@@ -150,28 +173,35 @@ public:
         {
             if (env <= 0.0001f) { active = false; break; }
             
-            // TR-808 spec: 325 Hz with pitch bend (10-20ms downward)
             pitchEnvTime += 1.0f / static_cast<float>(sampleRate);
-            float pitchBend = (pitchEnvTime < 0.015f) ? (1.0f + 0.05f * std::exp(-pitchEnvTime / 0.005f)) : 1.0f;
-            
             float currentTune = tune.getNextValue() + fineTune.getNextValue();
-            float baseFreq = 325.0f * std::pow(2.0f, currentTune / 12.0f);
-            float freq = (baseFreq * pitchBend) / static_cast<float>(sampleRate);
+            float freq = frequency(currentTune, pitchEnvTime) / static_cast<float>(sampleRate);
             
             float sample = std::sin(phase * juce::MathConstants<float>::twoPi) * env * level.getNextValue();
             phase += freq;
             if (phase >= 1.0f) phase -= 1.0f;
             
-            // Expo decay: 220ms
-            float decayTime = 0.22f * (0.5f + decay.getNextValue() * 0.5f);
-            float decayRate = std::exp(-1.0f / (decayTime * static_cast<float>(sampleRate)));
-            env *= decayRate;
+            env *= decayRate(decay.getNextValue());
 
             applyPan(buffer, startSample + i, numSamples, sample);
         }
     }
 
 private:
+    // TR-808 spec: 325 Hz with pitch bend (10-20ms downward)
+    static float frequency(float tuneSemitones, float time)
+    {
+        float pitchBend = (time < 0.015f) ? (1.0f + 0.05f * std::exp(-time / 0.005f)) : 1.0f;
+        return 325.0f * std::pow(2.0f, tuneSemitones / 12.0f) * pitchBend;
+    }
+
+    // Expo decay: 220ms
+    static float decayTime(float decaySetting) { return 0.22f * (0.5f + decaySetting * 0.5f); }
+    float decayRate(float decaySetting) const
+    {
+        return std::exp(-1.0f / (decayTime(decaySetting) * static_cast<float>(sampleRate)));
+    }
+
     float phase = 0.0f, env = 0.0f, pitchEnvTime = 0.0f;
     bool active = false;
 };
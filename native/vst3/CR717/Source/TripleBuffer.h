@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+/**
+ * Single-writer / single-reader triple buffer for handing whole values to the audio
+ * thread. The writer owns one slot, the reader another, the third is in flight, so
+ * publish() and acquire() are one atomic exchange each: neither side blocks, the reader
+ * never sees a half-written value, and nothing is allocated or freed after construction.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer only: copies the value into the writer's slot and makes it the newest
+    void publish(const T& value)
+    {
+        slots[static_cast<size_t>(writeIndex)] = value;
+        writeIndex = middle.exchange(writeIndex | DIRTY) & INDEX_MASK;
+    }
+
+    // Reader only: switches to the newest published value, if there is one, and returns it
+    const T& acquire()
+    {
+        if (middle.load(std::memory_order_relaxed) & DIRTY)
+            readIndex = middle.exchange(readIndex) & INDEX_MASK;
+        return slots[static_cast<size_t>(readIndex)];
+    }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int DIRTY = 4;
+
+    std::array<T, 3> slots{};
+    std::atomic<int> middle{1};
+    int writeIndex = 2, readIndex = 0;
+};
@@ -2,27 +2,98 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "VoiceInserts.h"
 
 class Voice
 {
 public:
+    // The per-voice parameters, in the units the setters below take. Sequencer parameter locks refer to these
+    enum Param { Level = 0, Tune, FineTune, Decay, Tone, Pan, FilterCutoff, FilterRes, NumParams };
+    
     Voice() = default;
     virtual ~Voice() = default;
 
     virtual void prepare(double sampleRate, int maxBlockSize) = 0;
-    virtual void trigger(float velocity) = 0;
+    // fraction (0-1): how far the hit's exact time lies before the sample it starts on.
+    // Oscillators and envelopes start that far in, so timing is finer than a sample
+    virtual void trigger(float velocity, float fraction = 0.0f) = 0;
     virtual bool isActive() const = 0;
     virtual void renderNextBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) = 0;
     virtual void stop() { /* Override if needed for choke groups */ }
     
+    // Insert FX: scratch space is sized here so rendering through the chain never allocates
+    void prepareInserts(double sr, int maxBlockSize)
+    {
+        inserts.prepare(sr);
+        monoScratch.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+        panScratchL.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+        panScratchR.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+    }
+
+    VoiceInsertChain& getInserts() { return inserts; }
+
+    // Renders the voice, routing its mono signal through the insert chain before panning.
+    // With every slot off this is a plain renderNextBlock() call.
+    void renderWithInserts(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+    {
+        const int capacity = static_cast<int>(monoScratch.size());
+        if (inserts.isBypassed() || capacity == 0)
+        {
+            renderNextBlock(buffer, startSample, numSamples);
+            return;
+        }
+
+        while (numSamples > 0)
+        {
+            const int n = juce::jmin(numSamples, capacity);
+
+            // Samples after the voice goes idle keep the current pan and a silent input
+            const float currentPan = pan.getCurrentValue();
+            std::fill(monoScratch.begin(), monoScratch.begin() + n, 0.0f);
+            std::fill(panScratchL.begin(), panScratchL.begin() + n, panGainLeft(currentPan));
+            std::fill(panScratchR.begin(), panScratchR.begin() + n, panGainRight(currentPan));
+
+            scratchStart = startSample;
+            renderingToScratch = true;
+            renderNextBlock(buffer, startSample, n);
+            renderingToScratch = false;
+
+            inserts.process(monoScratch.data(), n);
+
+            auto* left = buffer.getWritePointer(0, startSample);
+            auto* right = buffer.getWritePointer(1, startSample);
+            for (int i = 0; i < n; ++i)
+            {
+                left[i] += monoScratch[static_cast<size_t>(i)] * panScratchL[static_cast<size_t>(i)];
+                right[i] += monoScratch[static_cast<size_t>(i)] * panScratchR[static_cast<size_t>(i)];
+            }
+
+            startSample += n;
+            numSamples -= n;
+        }
+    }
+
     void setLevel(float level) { targetLevel = level; }
     void setTune(float semitones) { targetTune = semitones; }
     void setFineTune(float cents) { targetFineTune = cents; }
     void setDecay(float decay) { targetDecay = decay; }
     void setTone(float tone) { targetTone = tone; }
     void setPan(float pan) { targetPan = pan; }
-    void setFilterCutoff(float cutoff) { targetFilterCutoff = cutoff; }
-    void setFilterResonance(float res) { targetFilterRes = res; }
+    void setFilterCutoff(float cutoff) { baseFilterCutoff = cutoff; if (!isLocked(FilterCutoff)) targetFilterCutoff = cutoff; }
+    void setFilterResonance(float res) { baseFilterRes = res; if (!isLocked(FilterRes)) targetFilterRes = res; }
+    
+    // Overrides a parameter for the next trigger only; the value holds until the trigger after that
+    void lockParameter(Param param, float value)
+    {
+        if (param >= 0 && param < NumParams)
+        {
+            pendingLocks |= 1u << param;
+            lockedValues[static_cast<size_t>(param)] = value;
+        }
+    }
+    
+    // Shifts the next trigger's pitch, in semitones on top of Tune or its lock (ratchet pitch ramps)
+    void transposeNext(float semitones) { pendingTranspose = semitones; }
 
 protected:
     double sampleRate = 44100.0;
@@ -44,24 +115,71 @@ protected:
     float targetFilterCutoff = 1000.0f;
     float targetFilterRes = 0.5f;
     
+    // Called from trigger(). Locked values (and the first hit after a locked one) start
+    // exactly on their value instead of gliding there
     void updateSmoothedValues()
     {
-        level.setTargetValue(targetLevel);
-        tune.setTargetValue(targetTune);
-        fineTune.setTargetValue(targetFineTune);
-        decay.setTargetValue(targetDecay);
-        tone.setTargetValue(targetTone);
-        pan.setTargetValue(targetPan);
+        const bool transposed = pendingTranspose != 0.0f || heldTranspose != 0.0f;
+        const auto jumps = pendingLocks | heldLocks | (transposed ? 1u << Tune : 0u);
+        heldLocks = pendingLocks;
+        pendingLocks = 0;
+        heldTranspose = pendingTranspose;
+        pendingTranspose = 0.0f;
+        
+        startValue(level, Level, targetLevel, jumps);
+        startValue(tune, Tune, targetTune, jumps, heldTranspose);
+        startValue(fineTune, FineTune, targetFineTune, jumps);
+        startValue(decay, Decay, targetDecay, jumps);
+        startValue(tone, Tone, targetTone, jumps);
+        startValue(pan, Pan, targetPan, jumps);
+        targetFilterCutoff = isLocked(FilterCutoff) ? lockedValues[static_cast<size_t>(FilterCutoff)] : baseFilterCutoff;
+        targetFilterRes = isLocked(FilterRes) ? lockedValues[static_cast<size_t>(FilterRes)] : baseFilterRes;
     }
     
-    // Apply pan to stereo buffer
+    // Apply pan to stereo buffer (or capture into the insert scratch block)
     void applyPan(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float sample)
     {
+        juce::ignoreUnused(numSamples);
         float currentPan = pan.getNextValue();
-        float leftGain = std::cos((currentPan + 1.0f) * juce::MathConstants<float>::pi / 4.0f);
-        float rightGain = std::sin((currentPan + 1.0f) * juce::MathConstants<float>::pi / 4.0f);
+        float leftGain = panGainLeft(currentPan);
+        float rightGain = panGainRight(currentPan);
+        
+        if (renderingToScratch)
+        {
+            const auto i = static_cast<size_t>(startSample - scratchStart);
+            monoScratch[i] = sample;
+            panScratchL[i] = leftGain;
+            panScratchR[i] = rightGain;
+            return;
+        }
         
         buffer.getWritePointer(0)[startSample] += sample * leftGain;
         buffer.getWritePointer(1)[startSample] += sample * rightGain;
     }
+
+private:
+    bool isLocked(Param param) const { return ((heldLocks >> param) & 1u) != 0; }
+    
+    void startValue(juce::SmoothedValue<float>& value, Param param, float target, std::uint32_t jumps, float offset = 0.0f)
+    {
+        const float v = (isLocked(param) ? lockedValues[static_cast<size_t>(param)] : target) + offset;
+        if (((jumps >> param) & 1u) != 0)
+            value.setCurrentAndTargetValue(v);
+        else
+            value.setTargetValue(v);
+    }
+    
+    static float panGainLeft(float p) { return std::cos((p + 1.0f) * juce::MathConstants<float>::pi / 4.0f); }
+    static float panGainRight(float p) { return std::sin((p + 1.0f) * juce::MathConstants<float>::pi / 4.0f); }
+
+    // Parameter locks: pending for the next trigger, held for the hit playing now
+    std::array<float, NumParams> lockedValues{};
+    std::uint32_t pendingLocks = 0, heldLocks = 0;
+    float pendingTranspose = 0.0f, heldTranspose = 0.0f;
+    float baseFilterCutoff = 1000.0f, baseFilterRes = 0.5f;
+    
+    VoiceInsertChain inserts;
+    std::vector<float> monoScratch, panScratchL, panScratchR;
+    int scratchStart = 0;
+    bool renderingToScratch = false;
 };
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+/**
+ * Per-voice insert FX: drive, 3-band EQ, transient shaper, bitcrusher.
+ * Each slot owns the state for every effect type, so switching type never allocates.
+ * Processes the voice's mono signal in place, before panning.
+ *
+ * Slot parameters are normalised 0-1 and mean:
+ *   Drive      A = drive (0..24 dB)   B = tone (2k..20k LP)   C = output (+/-12 dB)
+ *   EQ         A = low (+/-12 dB)     B = mid (+/-12 dB)      C = high (+/-12 dB)
+ *   Transient  A = attack (+/-)       B = sustain (+/-)       C = output (+/-12 dB)
+ *   Bitcrusher A = bits (16..2)       B = rate (1..32x hold)  C = output (+/-12 dB)
+ */
+class VoiceInsert
+{
+public:
+    enum Type { Off = 0, Drive, EQ, Transient, Bitcrusher };
+
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        lastA = lastB = lastC = -1.0f;
+        reset();
+    }
+
+    void setType(int newType)
+    {
+        newType = juce::jlimit(0, static_cast<int>(Bitcrusher), newType);
+        if (newType != type)
+        {
+            type = newType;
+            lastA = lastB = lastC = -1.0f;
+            reset();
+        }
+    }
+
+    void setParameters(float a, float b, float c)
+    {
+        if (a == lastA && b == lastB && c == lastC)
+            return;
+
+        lastA = a; lastB = b; lastC = c;
+        outputGain = juce::Decibels::decibelsToGain((c - 0.5f) * 24.0f);
+
+        switch (type)
+        {
+            case Drive:
+            {
+                driveGain = juce::Decibels::decibelsToGain(a * 24.0f);
+                driveMakeup = 1.0f / std::tanh(driveGain);
+                float cutoff = 2000.0f * std::pow(10.0f, b); // 2k..20k
+                cutoff = juce::jmin(cutoff, static_cast<float>(sampleRate) * 0.45f);
+                toneCoeff = std::exp(-juce::MathConstants<float>::twoPi * cutoff / static_cast<float>(sampleRate));
+                break;
+            }
+            case EQ:
+                lowShelf.setLowShelf(sampleRate, 200.0, (a - 0.5f) * 24.0f);
+                midPeak.setPeak(sampleRate, 1200.0, 0.7, (b - 0.5f) * 24.0f);
+                highShelf.setHighShelf(sampleRate, 6000.0, (c - 0.5f) * 24.0f);
+                break;
+            case Transient:
+                attackAmount = (a - 0.5f) * 2.0f;
+                sustainAmount = (b - 0.5f) * 2.0f;
+                break;
+            case Bitcrusher:
+                quantSteps = std::pow(2.0f, 16.0f - a * 14.0f - 1.0f);
+                holdLength = 1 + static_cast<int>(b * 31.0f);
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool isActive() const { return type != Off; }
+
+    void process(float* data, int numSamples)
+    {
+        switch (type)
+        {
+            case Drive:      processDrive(data, numSamples); break;
+            case EQ:         processEQ(data, numSamples); break;
+            case Transient:  processTransient(data, numSamples); break;
+            case Bitcrusher: processBitcrusher(data, numSamples); break;
+            default: break;
+        }
+    }
+
+    void reset()
+    {
+        toneState = 0.0f;
+        lowShelf.reset(); midPeak.reset(); highShelf.reset();
+        fastEnv = slowEnv = shortEnv = longEnv = 0.0f;
+        heldSample = 0.0f;
+        holdCounter = 0;
+    }
+
+private:
+    // Direct-form biquad with RBJ cookbook designs (no heap, unlike dsp::IIR::Coefficients)
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float z1 = 0.0f, z2 = 0.0f;
+
+        void reset() { z1 = z2 = 0.0f; }
+
+        float processSample(float x)
+        {
+            const float y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+
+        void setLowShelf(double sr, double freq, float gainDb)
+        {
+            const double A = std::pow(10.0, gainDb / 40.0);
+            const double w0 = juce::MathConstants<double>::twoPi * freq / sr;
+            const double cw = std::cos(w0), alpha = std::sin(w0) / 2.0 * std::sqrt(2.0);
+            const double sqA = 2.0 * std::sqrt(A) * alpha;
+            setNormalised(A * ((A + 1) - (A - 1) * cw + sqA),
+                          2 * A * ((A - 1) - (A + 1) * cw),
+                          A * ((A + 1) - (A - 1) * cw - sqA),
+                          (A + 1) + (A - 1) * cw + sqA,
+                          -2 * ((A - 1) + (A + 1) * cw),
+                          (A + 1) + (A - 1) * cw - sqA);
+        }
+
+        void setHighShelf(double sr, double freq, float gainDb)
+        {
+            const double A = std::pow(10.0, gainDb / 40.0);
+            const double w0 = juce::MathConstants<double>::twoPi * freq / sr;
+            const double cw = std::cos(w0), alpha = std::sin(w0) / 2.0 * std::sqrt(2.0);
+            const double sqA = 2.0 * std::sqrt(A) * alpha;
+            setNormalised(A * ((A + 1) + (A - 1) * cw + sqA),
+                          -2 * A * ((A - 1) + (A + 1) * cw),
+                          A * ((A + 1) + (A - 1) * cw - sqA),
+                          (A + 1) - (A - 1) * cw + sqA,
+                          2 * ((A - 1) - (A + 1) * cw),
+                          (A + 1) - (A - 1) * cw - sqA);
+        }
+
+        void setPeak(double sr, double freq, double q, float gainDb)
+        {
+            const double A = std::pow(10.0, gainDb / 40.0);
+            const double w0 = juce::MathConstants<double>::twoPi * freq / sr;
+            const double cw = std::cos(w0), alpha = std::sin(w0) / (2.0 * q);
+            setNormalised(1 + alpha * A, -2 * cw, 1 - alpha * A,
+                          1 + alpha / A, -2 * cw, 1 - alpha / A);
+        }
+
+        void setNormalised(double nb0, double nb1, double nb2, double na0, double na1, double na2)
+        {
+            b0 = static_cast<float>(nb0 / na0);
+            b1 = static_cast<float>(nb1 / na0);
+            b2 = static_cast<float>(nb2 / na0);
+            a1 = static_cast<float>(na1 / na0);
+            a2 = static_cast<float>(na2 / na0);
+        }
+    };
+
+    void processDrive(float* data, int numSamples)
+    {
+        const float gain = driveMakeup * outputGain;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = std::tanh(data[i] * driveGain);
+            toneState = x + toneCoeff * (toneState - x);
+            data[i] = toneState * gain;
+        }
+    }
+
+    void processEQ(float* data, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = highShelf.processSample(midPeak.processSample(lowShelf.processSample(data[i])));
+    }
+
+    void processTransient(float* data, int numSamples)
+    {
+        const float sr = static_cast<float>(sampleRate);
+        const float fastAtt = std::exp(-1.0f / (0.0005f * sr));
+        const float slowAtt = std::exp(-1.0f / (0.015f * sr));
+        const float shortRel = std::exp(-1.0f / (0.02f * sr));
+        const float longRel = std::exp(-1.0f / (0.3f * sr));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = std::abs(data[i]);
+
+            // Attack detector: fast vs slow attack, shared release
+            fastEnv = x > fastEnv ? x + fastAtt * (fastEnv - x) : x + shortRel * (fastEnv - x);
+            slowEnv = x > slowEnv ? x + slowAtt * (slowEnv - x) : x + shortRel * (slowEnv - x);
+
+            // Sustain detector: instant attack, short vs long release
+            shortEnv = x > shortEnv ? x : x + shortRel * (shortEnv - x);
+            longEnv = x > longEnv ? x : x + longRel * (longEnv - x);
+
+            const float attackSig = juce::jlimit(0.0f, 1.0f, (fastEnv - slowEnv) / (fastEnv + 1.0e-6f));
+            const float sustainSig = juce::jlimit(0.0f, 1.0f, (longEnv - shortEnv) / (longEnv + 1.0e-6f));
+
+            // Up to +/-12 dB per detector (dB / 6.0206 = log2 gain)
+            const float gainDb = 12.0f * (attackAmount * attackSig + sustainAmount * sustainSig);
+            data[i] *= std::exp2(gainDb * 0.16609640f) * outputGain;
+        }
+    }
+
+    void processBitcrusher(float* data, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (holdCounter <= 0)
+            {
+                heldSample = std::round(data[i] * quantSteps) / quantSteps;
+                holdCounter = holdLength;
+            }
+            --holdCounter;
+            data[i] = heldSample * outputGain;
+        }
+    }
+
+    double sampleRate = 44100.0;
+    int type = Off;
+    float lastA = -1.0f, lastB = -1.0f, lastC = -1.0f;
+    float outputGain = 1.0f;
+
+    // Drive
+    float driveGain = 1.0f, driveMakeup = 1.0f, toneCoeff = 0.0f, toneState = 0.0f;
+
+    // EQ
+    Biquad lowShelf, midPeak, highShelf;
+
+    // Transient shaper
+    float attackAmount = 0.0f, sustainAmount = 0.0f;
+    float fastEnv = 0.0f, slowEnv = 0.0f, shortEnv = 0.0f, longEnv = 0.0f;
+
+    // Bitcrusher
+    float quantSteps = 32768.0f, heldSample = 0.0f;
+    int holdLength = 1, holdCounter = 0;
+};
+
+class VoiceInsertChain
+{
+public:
+    static constexpr int NUM_SLOTS = 2;
+
+    void prepare(double sampleRate)
+    {
+        for (auto& slot : slots)
+            slot.prepare(sampleRate);
+    }
+
+    VoiceInsert& getSlot(int index) { return slots[static_cast<size_t>(index)]; }
+
+    bool isBypassed() const
+    {
+        for (const auto& slot : slots)
+            if (slot.isActive())
+                return false;
+        return true;
+    }
+
+    void process(float* data, int numSamples)
+    {
+        for (auto& slot : slots)
+            if (slot.isActive())
+                slot.process(data, numSamples);
+    }
+
+    void reset()
+    {
+        for (auto& slot : slots)
+            slot.reset();
+    }
+
+private:
+    std::array<VoiceInsert, NUM_SLOTS> slots;
+};
@@ -67,6 +67,16 @@ public:
         }
         patternButtons[0]->setToggleState(true, juce::dontSendNotification);
         
+        // Randomize the pattern in the preset's style
+        randomizeButton.setButtonText("RND");
+        randomizeButton.setTooltip("Randomize pattern");
+        randomizeButton.onClick = [this]
+        {
+            if (onRandomize)
+                onRandomize();
+        };
+        addAndMakeVisible(randomizeButton);
+        
         // Apply theme
         applyTheme();
     }
@@ -130,6 +140,9 @@ public:
             patternSection.removeFromLeft(Spacing::xs);
         }
         
+        bounds.removeFromLeft(Spacing::sm);
+        randomizeButton.setBounds(bounds.removeFromLeft(48));
+        
         // Right section: Preset selector
         presetCombo.setBounds(bounds.removeFromRight(200));
     }
@@ -138,6 +151,7 @@ public:
     std::function<void(double)> onBPMChange;
     std::function<void(int)> onPresetChange;
     std::function<void(int)> onPatternChange;
+    std::function<void()> onRandomize;
     
     // Populate preset combo with display names
     void setPresetList(const juce::StringArray& names)
@@ -183,6 +197,9 @@ private:
             btn->setColour(juce::TextButton::textColourOffId, Colors::textSecondary);
             btn->setColour(juce::TextButton::textColourOnId, Colors::textPrimary);
         }
+        
+        randomizeButton.setColour(juce::TextButton::buttonColourId, Colors::bgTertiary);
+        randomizeButton.setColour(juce::TextButton::textColourOffId, Colors::textSecondary);
     }
     
     juce::TextButton playButton;
@@ -191,6 +208,7 @@ private:
     juce::ComboBox presetCombo;
     juce::Label patternLabel;
     juce::OwnedArray<juce::TextButton> patternButtons;
+    juce::TextButton randomizeButton;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HeaderPanel)
 };
@@ -50,7 +50,8 @@ public:
     {
         if (channel >= 0 && channel < 2)
         {
-            peakLevels[channel] = juce::jlimit(0.0f, 1.0f, level);
+            // Fall back at ~30 dB/s between frames; rises are immediate
+            peakLevels[channel] = juce::jlimit(0.0f, 1.0f, juce::jmax(level, peakLevels[channel] * 0.9f));
             
             // Update peak hold
             if (level > peakHolds[channel])
@@ -140,6 +141,124 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoMeter)
 };
 
+/**
+ * Compressor gain reduction per band (low / mid / high), 0 to -24 dB
+ * Bars grow from the left; single-band mode shows the same value on all three
+ */
+class GainReductionMeter : public juce::Component
+{
+public:
+    void paint(juce::Graphics& g) override
+    {
+        using namespace DesignTokens;
+        
+        auto bounds = getLocalBounds().toFloat();
+        g.setColour(Colors::bgPrimary);
+        g.fillRoundedRectangle(bounds, Radius::sm);
+        
+        const char* labels[3] = {"L", "M", "H"};
+        auto rows = bounds.reduced(2.0f);
+        const float rowHeight = rows.getHeight() / 3.0f;
+        
+        for (int band = 0; band < 3; ++band)
+        {
+            auto row = rows.removeFromTop(rowHeight);
+            g.setColour(Colors::textMuted);
+            g.setFont(juce::Font(8.0f));
+            g.drawText(labels[band], row.removeFromLeft(10.0f), juce::Justification::centred);
+            
+            auto bar = row.reduced(1.0f, 1.0f);
+            const float amount = juce::jlimit(0.0f, 1.0f, -reductionDb[band] / 24.0f);
+            g.setColour(Colors::warning);
+            g.fillRect(bar.withWidth(bar.getWidth() * amount));
+        }
+        
+        g.setColour(Colors::border);
+        g.drawRoundedRectangle(bounds, Radius::sm, 1.0f);
+    }
+    
+    void setGainReduction(int band, float db)
+    {
+        if (band >= 0 && band < 3 && std::abs(db - reductionDb[band]) > 0.05f)
+        {
+            reductionDb[band] = db;
+            repaint();
+        }
+    }
+    
+private:
+    float reductionDb[3] = {0.0f, 0.0f, 0.0f};
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainReductionMeter)
+};
+
+/**
+ * EBU R128 readout: momentary, short-term, integrated (LUFS), LRA and max true peak
+ * Click to start a new integrated measurement
+ */
+class LoudnessDisplay : public juce::Component
+{
+public:
+    void paint(juce::Graphics& g) override
+    {
+        using namespace DesignTokens;
+        
+        auto bounds = getLocalBounds().toFloat();
+        g.setColour(Colors::bgPrimary);
+        g.fillRoundedRectangle(bounds, Radius::sm);
+        g.setColour(Colors::border);
+        g.drawRoundedRectangle(bounds, Radius::sm, 1.0f);
+        
+        auto rows = getLocalBounds().reduced(Spacing::xs, 2);
+        const int rowHeight = rows.getHeight() / 3;
+        g.setFont(juce::Font(Typography::xs));
+        
+        auto drawRow = [&](const juce::String& leftLabel, const juce::String& leftValue,
+                           const juce::String& rightLabel, const juce::String& rightValue, juce::Colour rightColour)
+        {
+            auto row = rows.removeFromTop(rowHeight);
+            auto left = row.removeFromLeft(row.getWidth() / 2);
+            g.setColour(Colors::textMuted);
+            g.drawText(leftLabel, left, juce::Justification::centredLeft);
+            g.drawText(rightLabel, row, juce::Justification::centredLeft);
+            g.setColour(Colors::textPrimary);
+            g.drawText(leftValue, left.withTrimmedRight(Spacing::xs), juce::Justification::centredRight);
+            g.setColour(rightColour);
+            g.drawText(rightValue, row, juce::Justification::centredRight);
+        };
+        
+        drawRow("M", format(momentary), "S", format(shortTerm), Colors::textPrimary);
+        drawRow("I", format(integrated), "LRA", juce::String(range, 1), Colors::textPrimary);
+        drawRow("LUFS", {}, "TP", format(maxTruePeak), maxTruePeak > truePeakTarget ? Colors::danger : Colors::textPrimary);
+    }
+    
+    void mouseDown(const juce::MouseEvent&) override
+    {
+        if (onReset)
+            onReset();
+    }
+    
+    void setValues(float newMomentary, float newShortTerm, float newIntegrated, float newRange, float newMaxTruePeak)
+    {
+        momentary = newMomentary;
+        shortTerm = newShortTerm;
+        integrated = newIntegrated;
+        range = newRange;
+        maxTruePeak = newMaxTruePeak;
+        repaint();
+    }
+    
+    std::function<void()> onReset;
+    
+private:
+    static juce::String format(float value) { return value > -70.0f ? juce::String(value, 1) : juce::String("--"); }
+    
+    static constexpr float truePeakTarget = -0.3f; // dBTP, see PERFORMANCE_TEST.md
+    float momentary = -100.0f, shortTerm = -100.0f, integrated = -100.0f, range = 0.0f, maxTruePeak = -100.0f;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessDisplay)
+};
+
 /**
  * Master & FX panel (right rail, 3 columns)
  * Elevation: L2 with shadow
@@ -166,6 +285,12 @@ public:
         clipIndicator.setColour(juce::TextButton::textColourOffId, DesignTokens::Colors::danger);
         addAndMakeVisible(clipIndicator);
         
+        // Compressor gain reduction
+        addAndMakeVisible(grMeter);
+        
+        // Loudness
+        addAndMakeVisible(loudness);
+        
         // Output gain
         outputGain = std::make_unique<RotaryKnob>(RotaryKnob::Size::Medium, "Output");
         outputGain->setRange(-12.0, 12.0, 0.1);
@@ -275,7 +400,7 @@ public:
         g.setColour(Colors::border.withAlpha(0.3f));
         
         // After meters
-        float y = 40 + 120 + 40 + 80;
+        float y = static_cast<float>(separatorY);
         g.drawLine(12, y, bounds.getWidth() - 12, y, 1.0f);
     }
     
@@ -297,9 +422,18 @@ public:
         clipIndicator.setBounds(bounds.removeFromTop(24).reduced(Spacing::lg, 0));
         bounds.removeFromTop(Spacing::sm);
         
+        // Gain reduction
+        grMeter.setBounds(bounds.removeFromTop(30).reduced(Spacing::lg, 0));
+        bounds.removeFromTop(Spacing::sm);
+        
+        // Loudness readout
+        loudness.setBounds(bounds.removeFromTop(42).reduced(Spacing::sm, 0));
+        bounds.removeFromTop(Spacing::sm);
+        
         // Output gain
         auto gainBounds = bounds.removeFromTop(60);
         outputGain->setBounds(gainBounds.withSizeKeepingCentre(48, 60));
+        separatorY = bounds.getY() + Spacing::lg / 2;
         bounds.removeFromTop(Spacing::lg);
         
         // FX section
@@ -362,6 +496,8 @@ public:
     }
     
     StereoMeter& getMeters() { return meters; }
+    GainReductionMeter& getGainReductionMeter() { return grMeter; }
+    LoudnessDisplay& getLoudnessDisplay() { return loudness; }
     RotaryKnob& getOutputGain() { return *outputGain; }
     RotaryKnob& getReverbSize() { return *reverbSize; }
     RotaryKnob& getReverbDamp() { return *reverbDamp; }
@@ -389,7 +525,10 @@ private:
     juce::Label titleLabel;
     StereoMeter meters;
     juce::TextButton clipIndicator;
+    GainReductionMeter grMeter;
+    LoudnessDisplay loudness;
     std::unique_ptr<RotaryKnob> outputGain;
+    int separatorY = 0;
     
     juce::Label fxLabel;
     std::unique_ptr<RotaryKnob> reverbSize;
@@ -0,0 +1,67 @@
+#include "../../Source/MasterDynamics.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+// Clipper cost per host sample at small buffers, for each anti-aliasing strategy
+static double nanosecondsPerSample(int oversampling, int antialias, int curve)
+{
+    const double sampleRate = 48000.0;
+    const int blockSize = 64;
+    MasterDynamics dynamics;
+    dynamics.prepare(sampleRate, blockSize);
+    dynamics.setClipperDrive(12.0f);
+    dynamics.setClipperMix(100.0f);
+    dynamics.setClipperCurve(curve);
+    dynamics.setClipperAntialias(antialias);
+    dynamics.setClipperOversampling(oversampling);
+    
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    const int numBlocks = static_cast<int>(sampleRate * 4.0) / blockSize; // 4 seconds of audio
+    double phase = 0.0;
+    
+    const auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const float x = 0.5f * static_cast<float>(std::sin(phase));
+            buffer.setSample(0, i, x);
+            buffer.setSample(1, i, x);
+            phase += juce::MathConstants<double>::twoPi * 997.0 / sampleRate;
+        }
+        dynamics.process(buffer, false, false, true);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (numBlocks * blockSize);
+}
+
+int main()
+{
+    std::cout << "=== Clipper Anti-Aliasing Benchmark (ns/sample, 64-sample blocks, incl. test signal) ===" << std::endl;
+    
+    bool overBudget = false;
+    const char* curveNames[] = {"Tanh", "Atan", "Poly"};
+    for (int curve = 0; curve < 3; ++curve)
+    {
+        const double plain4x = nanosecondsPerSample(2, 0, curve);
+        const double plain2x = nanosecondsPerSample(1, 0, curve);
+        const double adaa1 = nanosecondsPerSample(0, 1, curve);
+        const double adaa2 = nanosecondsPerSample(0, 2, curve);
+        const double adaa2At2x = nanosecondsPerSample(1, 2, curve);
+        
+        std::cout << curveNames[curve] << ": 4x " << plain4x << ", 2x " << plain2x
+                  << ", 1x ADAA1 " << adaa1 << ", 1x ADAA2 " << adaa2 << ", 2x ADAA2 " << adaa2At2x
+                  << " (1x ADAA1/2x = " << adaa1 / plain2x << ")" << std::endl;
+        
+        // The point of ADAA: first order at the host rate undercuts any oversampled mode
+        if (adaa1 / plain2x >= 1.0)
+        {
+            std::cout << "  over budget (1x ADAA1 < 2x)" << std::endl;
+            overBudget = true;
+        }
+    }
+    
+    return overBudget ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+#include "../../Source/MasterDynamics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+// Compressor cost per sample across sample rates. The RMS window is 10 ms, so a
+// detector that rescans the window would cost 4.4x more at 192k than at 44.1k.
+static double nanosecondsPerSample(double sampleRate, bool rmsMode, int rmsType,
+                                   int linkMode = MasterDynamics::MonoSum,
+                                   int bandMode = MasterDynamics::SingleBand)
+{
+    const int blockSize = 256;
+    MasterDynamics dynamics;
+    dynamics.prepare(sampleRate, blockSize);
+    dynamics.setThreshold(-24.0f);
+    dynamics.setRatio(4.0f);
+    dynamics.setKnee(6.0f);
+    dynamics.setDetectorMode(rmsMode);
+    dynamics.setRmsDetectorType(rmsType);
+    dynamics.setLinkMode(linkMode);
+    dynamics.setBandMode(bandMode);
+    
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    const int numBlocks = static_cast<int>(sampleRate * 4.0) / blockSize; // 4 seconds of audio
+    double phase = 0.0;
+    
+    const auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const float x = 0.5f * static_cast<float>(std::sin(phase));
+            buffer.setSample(0, i, x);
+            buffer.setSample(1, i, 0.7f * x);
+            phase += juce::MathConstants<double>::twoPi * 100.0 / sampleRate;
+        }
+        dynamics.process(buffer, true, false, false);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (numBlocks * blockSize);
+}
+
+int main()
+{
+    std::cout << "=== Compressor Detector Benchmark (ns/sample, incl. test signal) ===" << std::endl;
+    
+    bool overBudget = false;
+    const char* modes[] = {"Peak", "RMS Window", "RMS Smooth"};
+    for (int m = 0; m < 3; ++m)
+    {
+        const bool rms = m > 0;
+        const int type = m == 2 ? RmsDetector::Smooth : RmsDetector::Window;
+        
+        double at44 = nanosecondsPerSample(44100.0, rms, type);
+        double at96 = nanosecondsPerSample(96000.0, rms, type);
+        double at192 = nanosecondsPerSample(192000.0, rms, type);
+        
+        std::cout << modes[m] << ": 44.1k " << at44 << ", 96k " << at96 << ", 192k " << at192
+                  << " (192k/44.1k = " << at192 / at44 << ")" << std::endl;
+        
+        // Cost per sample must not scale with the window length
+        const double rateBudget = 2.0;
+        if (at192 / at44 > rateBudget)
+        {
+            std::cout << "  over budget (192k/44.1k <= " << rateBudget << ")" << std::endl;
+            overBudget = true;
+        }
+    }
+    
+    // Every link mode runs the same lane-pair loop, so they should cost about the same
+    std::cout << "\nLink modes at 48k (RMS Window):" << std::endl;
+    const char* links[] = {"Mono Sum", "Max Linked", "Unlinked", "Mid/Side"};
+    for (int link = 0; link < 4; ++link)
+        std::cout << links[link] << ": " << nanosecondsPerSample(48000.0, true, RmsDetector::Window, link) << std::endl;
+    
+    // 3-band: the crossover, three detectors and the band sum. Budgeted at 4x single-band
+    std::cout << "\nBand modes at 48k (RMS Window, Max Linked):" << std::endl;
+    double single = 1.0e9, threeBand = 1.0e9;
+    for (int run = 0; run < 3; ++run) // best of three, the machine is noisy
+    {
+        single = std::min(single, nanosecondsPerSample(48000.0, true, RmsDetector::Window,
+                                                       MasterDynamics::MaxLinked, MasterDynamics::SingleBand));
+        threeBand = std::min(threeBand, nanosecondsPerSample(48000.0, true, RmsDetector::Window,
+                                                             MasterDynamics::MaxLinked, MasterDynamics::ThreeBand));
+    }
+    std::cout << "Single: " << single << ", 3-Band: " << threeBand << " (" << threeBand / single << "x)" << std::endl;
+    const double bandBudget = 4.0;
+    if (threeBand / single > bandBudget)
+    {
+        std::cout << "  over budget (3-Band <= " << bandBudget << "x)" << std::endl;
+        overBudget = true;
+    }
+    
+    return overBudget ? 1 : 0;
+}
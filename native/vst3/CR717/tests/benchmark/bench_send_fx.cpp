@@ -0,0 +1,99 @@
+#include "../../Source/Reverb.h"
+#include "../../Source/Delay.h"
+#include "../../Source/SendResampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+// Reverb + delay cost per host sample, both sends wired as in the processor: eco mode
+// decimates each send, runs the effect at the low rate and interpolates back
+static double nanosecondsPerSample(double sampleRate, int factor)
+{
+    const int blockSize = 512;
+    AlgorithmicReverb reverb;
+    TempoSyncDelay delay;
+    SendResampler reverbResampler, delayResampler;
+    const int fxBlockSize = factor > 1 ? SendResampler::getMaxLowBlockSize(blockSize) : blockSize;
+    reverb.prepare(sampleRate / factor, fxBlockSize);
+    delay.prepare(sampleRate / factor, fxBlockSize);
+    reverbResampler.prepare(blockSize, factor);
+    delayResampler.prepare(blockSize, factor);
+    reverb.setRoomSize(0.7f);
+    reverb.setWetLevel(1.0f);
+    delay.setDelayTime(0.25f, 120.0);
+    delay.setFeedback(0.5f);
+    delay.setWetLevel(1.0f);
+    
+    // A short noise burst every block keeps both tails busy
+    juce::AudioBuffer<float> burst(2, blockSize), reverbBus(2, blockSize), delayBus(2, blockSize);
+    juce::Random random(1);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            burst.setSample(ch, i, i < 32 ? random.nextFloat() - 0.5f : 0.0f);
+    const int numBlocks = static_cast<int>(sampleRate * 4.0) / blockSize; // 4 seconds of audio
+    
+    const auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            reverbBus.copyFrom(ch, 0, burst, ch, 0, blockSize);
+            delayBus.copyFrom(ch, 0, burst, ch, 0, blockSize);
+        }
+        
+        if (factor > 1)
+        {
+            const int reverbLow = reverbResampler.down(reverbBus, blockSize);
+            reverb.process(reverbResampler.getLowBuffer(), reverbLow);
+            reverbResampler.up(reverbBus, blockSize);
+            const int delayLow = delayResampler.down(delayBus, blockSize);
+            delay.process(delayResampler.getLowBuffer(), delayLow);
+            delayResampler.up(delayBus, blockSize);
+        }
+        else
+        {
+            reverb.process(reverbBus, blockSize);
+            delay.process(delayBus, blockSize);
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (numBlocks * blockSize);
+}
+
+int main()
+{
+    std::cout << "=== Send FX Eco Mode Benchmark (ns/host sample, reverb + delay, resamplers included) ===" << std::endl;
+    
+    bool overBudget = false;
+    for (double sampleRate : {96000.0, 192000.0})
+    {
+        // Best of three, the machine is noisy
+        double off = 1.0e9, half = 1.0e9, quarter = 1.0e9;
+        for (int run = 0; run < 3; ++run)
+        {
+            off = std::min(off, nanosecondsPerSample(sampleRate, 1));
+            half = std::min(half, nanosecondsPerSample(sampleRate, 2));
+            quarter = std::min(quarter, nanosecondsPerSample(sampleRate, 4));
+        }
+        
+        std::cout << sampleRate / 1000.0 << "k: Off " << off << ", 1/2 " << half << " (" << half / off
+                  << "x), 1/4 " << quarter << " (" << quarter / off << "x)";
+        if (sampleRate / 4 < 44100.0)
+            std::cout << " - the plugin runs 1/4 as 1/2 here, it never goes below 44.1k";
+        std::cout << std::endl;
+        
+        // Budgets: each halving of the rate has to pay for its resampler stage with room to
+        // spare. 1/4 is only checked where the plugin runs it
+        const double halfBudget = 0.8, quarterBudget = 0.65;
+        const bool quarterRuns = sampleRate / 4 >= 44100.0;
+        if (half / off > halfBudget || (quarterRuns && quarter / off > quarterBudget))
+        {
+            std::cout << "  over budget (1/2 <= " << halfBudget << "x, 1/4 <= " << quarterBudget << "x)" << std::endl;
+            overBudget = true;
+        }
+    }
+    
+    return overBudget ? 1 : 0;
+}
@@ -48,9 +48,133 @@ void testFullChain()
     std::cout << "✓ Full dynamics chain working correctly" << std::endl;
 }
 
+void testReportedLatency()
+{
+    MasterDynamics dynamics;
+    dynamics.prepare(48000.0, 512);
+    
+    // Transparent settings, but every stage that delays the signal is active
+    dynamics.setThreshold(0.0f);
+    dynamics.setRatio(1.0f);
+    dynamics.setLookahead(2.0f);
+    
+    dynamics.setClipperDrive(0.0f);
+    dynamics.setClipperMix(50.0f);
+    dynamics.setClipperOversampling(2);
+    
+    dynamics.setLimiterCeiling(0.0f);
+    dynamics.setLimiterLookahead(5.0f);
+    dynamics.setLimiterOversampling(false);
+    
+    const int latency = dynamics.getLatencySamples(true, true, true);
+    assert(latency > 96 + 240); // At least both lookaheads
+    assert(latency < 512 - 10);
+    
+    // Let the parameter smoothing settle first
+    juce::AudioBuffer<float> buffer(2, 512);
+    for (int b = 0; b < 4; ++b)
+    {
+        buffer.clear();
+        dynamics.process(buffer, true, true, true);
+    }
+    
+    buffer.clear();
+    buffer.setSample(0, 10, 0.25f);
+    buffer.setSample(1, 10, 0.25f);
+    
+    dynamics.process(buffer, true, true, true);
+    
+    int peakIndex = 0;
+    float peak = 0.0f;
+    for (int i = 0; i < 512; ++i)
+    {
+        if (std::abs(buffer.getSample(0, i)) > peak)
+        {
+            peak = std::abs(buffer.getSample(0, i));
+            peakIndex = i;
+        }
+    }
+    
+    std::cout << "Integration Test: Reported latency " << latency
+              << ", impulse found at +" << (peakIndex - 10) << " (" << peak << ")" << std::endl;
+    
+    // Dry and oversampled wet halves of the clipper mix land on the same sample
+    assert(std::abs(peakIndex - 10 - latency) <= 1);
+    assert(peak > 0.17f); // Misaligned halves would peak at ~0.125
+    
+    // Disabled stages add nothing
+    assert(dynamics.getLatencySamples(false, false, false) == 0);
+    
+    std::cout << "✓ Reported latency matches the processed signal" << std::endl;
+}
+
+void testSharedOversampling()
+{
+    MasterDynamics dynamics;
+    dynamics.prepare(48000.0, 512);
+    
+    dynamics.setClipperDrive(0.0f);
+    dynamics.setClipperMix(50.0f);
+    dynamics.setClipperOversampling(2);
+    dynamics.setLimiterCeiling(-6.0f);
+    dynamics.setLimiterOversampling(true);
+    
+    // Clipper into limiter costs one oversampler round trip, not two
+    const int shared = dynamics.getLatencySamples(false, true, true);
+    assert(shared == dynamics.getLatencySamples(false, true, false));
+    assert(dynamics.getLatencySamples(false, true, true, false) > shared);
+    
+    juce::AudioBuffer<float> buffer(2, 512);
+    for (int b = 0; b < 4; ++b)
+    {
+        buffer.clear();
+        dynamics.process(buffer, false, true, true);
+    }
+    
+    // Impulse well below the ceiling lands at the reported latency
+    buffer.clear();
+    buffer.setSample(0, 10, 0.25f);
+    buffer.setSample(1, 10, 0.25f);
+    dynamics.process(buffer, false, true, true);
+    
+    int peakIndex = 0;
+    float peak = 0.0f;
+    for (int i = 0; i < 512; ++i)
+    {
+        if (std::abs(buffer.getSample(0, i)) > peak)
+        {
+            peak = std::abs(buffer.getSample(0, i));
+            peakIndex = i;
+        }
+    }
+    assert(std::abs(peakIndex - 10 - shared) <= 1);
+    
+    // A hot sine is held near the ceiling
+    const float ceiling = juce::Decibels::decibelsToGain(-6.0f);
+    float maxOut = 0.0f;
+    for (int b = 0; b < 8; ++b)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < 512; ++i)
+                buffer.setSample(ch, i, 1.5f * std::sin(juce::MathConstants<float>::twoPi * 997.0f * (b * 512 + i) / 48000.0f));
+        dynamics.process(buffer, false, true, true);
+        if (b >= 2)
+            for (int i = 0; i < 512; ++i)
+                maxOut = std::max(maxOut, std::abs(buffer.getSample(0, i)));
+    }
+    
+    std::cout << "Integration Test: Shared clipper/limiter latency " << shared
+              << ", sine peak " << juce::Decibels::gainToDecibels(maxOut) << " dB" << std::endl;
+    assert(maxOut < ceiling * 1.05f);
+    
+    std::cout << "✓ Clipper and limiter share one oversampled section" << std::endl;
+}
+
 int main()
 {
     std::cout << "=== Dynamics Chain Integration Test ===" << std::endl;
     testFullChain();
+    testReportedLatency();
+    testSharedOversampling();
     return 0;
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../../../Source/Sequencer.h"
+#include "../../../Source/Voice.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <vector>
+
+// Exposes what a hit starts with, renders nothing
+class ProbeVoice : public Voice
+{
+public:
+    void prepare(double sr, int) override
+    {
+        sampleRate = sr;
+        tune.reset(sr, 0.02);
+        decay.reset(sr, 0.02);
+    }
+    void trigger(float, float = 0.0f) override { updateSmoothedValues(); }
+    bool isActive() const override { return false; }
+    void renderNextBlock(juce::AudioBuffer<float>&, int, int) override {}
+
+    float startTune() const { return tune.getCurrentValue(); }
+    float targetTune() const { return tune.getTargetValue(); }
+    float startDecay() const { return decay.getCurrentValue(); }
+    float cutoff() const { return targetFilterCutoff; }
+};
+
+// A trigger, at the absolute sample time it was reported on
+struct Hit
+{
+    int64_t sampleTime;
+    int voice;
+    float velocity;
+    float transpose;
+    float fraction;
+    std::vector<Sequencer::ParamLock> locks;
+
+    bool operator==(const Hit& other) const
+    {
+        return sampleTime == other.sampleTime && voice == other.voice && velocity == other.velocity
+            && transpose == other.transpose && fraction == other.fraction;
+    }
+};
+
+// Runs the sequencer over numSamples in blocks of blockSize (the last one may be short),
+// recording every hit and advancing clock
+inline std::vector<Hit> render(Sequencer& sequencer, int numSamples, int blockSize, int64_t& clock)
+{
+    std::vector<Hit> hits;
+    for (int done = 0; done < numSamples; done += blockSize)
+    {
+        const int n = std::min(blockSize, numSamples - done);
+        sequencer.process(n, [&](int offset, const Sequencer::Trigger& hit) {
+            assert(offset >= 0 && offset < n);
+            assert(hit.fraction >= 0.0f && hit.fraction < 1.0f);
+            hits.push_back({clock + offset, hit.voice, hit.velocity, hit.transpose, hit.fraction,
+                            {hit.locks, hit.locks + hit.numLocks}});
+        });
+        clock += n;
+    }
+    return hits;
+}
+
+inline std::vector<Hit> hitsOn(const std::vector<Hit>& hits, int voice)
+{
+    std::vector<Hit> result;
+    std::copy_if(hits.begin(), hits.end(), std::back_inserter(result), [voice](const Hit& h) { return h.voice == voice; });
+    return result;
+}
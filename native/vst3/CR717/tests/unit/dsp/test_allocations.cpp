@@ -0,0 +1,199 @@
+#include "../../../Source/MasterDynamics.h"
+#include "../../../Source/LoudnessMeter.h"
+#include "../../../Source/TomVoice.h"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Counts heap allocations made while tracking is switched on
+static std::atomic<bool> trackAllocations { false };
+static std::atomic<int> allocationCount { 0 };
+
+// Every replacement routes through this one pair. Kept out of line so the compiler never
+// sees a malloc/free pair straddling operator new and delete (-Wmismatched-new-delete)
+[[gnu::noinline]] static void* allocate(std::size_t size, std::size_t alignment)
+{
+    if (trackAllocations.load())
+        ++allocationCount;
+    size = size == 0 ? 1 : size;
+    if (alignment > alignof(std::max_align_t))
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    return std::malloc(size);
+}
+
+[[gnu::noinline]] static void release(void* p) noexcept { std::free(p); }
+
+static void* allocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    if (void* p = allocate(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t a) { return allocateOrThrow(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a) { return allocateOrThrow(size, static_cast<std::size_t>(a)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(a)); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+
+static void fillNoise(juce::AudioBuffer<float>& buffer, juce::Random& random, float level)
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(ch, i, level * (random.nextFloat() * 2.0f - 1.0f));
+}
+
+// Runs the full chain with the given settings and returns how many allocations process() made
+static int countAllocations(MasterDynamics& dynamics, juce::AudioBuffer<float>& buffer, int numBlocks)
+{
+    juce::Random random(42);
+    allocationCount = 0;
+    
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        fillNoise(buffer, random, 1.5f);
+        
+        // Parameter moves that used to reallocate (SC HPF coefficients)
+        dynamics.setScHpfFreq(b % 2 == 0 ? 60.0f : 200.0f);
+        
+        trackAllocations = true;
+        dynamics.process(buffer, true, true, true);
+        trackAllocations = false;
+    }
+    
+    return allocationCount.load();
+}
+
+void testNoAllocationsInProcess()
+{
+    MasterDynamics dynamics;
+    dynamics.prepare(48000.0, 512);
+    dynamics.setLookahead(2.0f);
+    dynamics.setClipperDrive(12.0f);
+    dynamics.setClipperMix(50.0f);
+    
+    juce::AudioBuffer<float> buffer(2, 512);
+    
+    const int osModes[] = {0, 1, 2};
+    for (int os : osModes)
+    {
+        dynamics.setClipperOversampling(os);
+        for (bool limiterOs : {false, true})
+        {
+            dynamics.setLimiterOversampling(limiterOs);
+            const int count = countAllocations(dynamics, buffer, 16);
+            std::cout << "Test: Clipper OS " << os << ", limiter OS " << limiterOs
+                      << " - allocations: " << count << std::endl;
+            assert(count == 0);
+        }
+    }
+}
+
+void testSmallAndOversizedBlocks()
+{
+    MasterDynamics dynamics;
+    dynamics.prepare(48000.0, 256);
+    dynamics.setClipperOversampling(2);
+    dynamics.setLimiterOversampling(true);
+    
+    // Hosts may send shorter blocks, and occasionally longer ones than announced
+    for (int blockSize : {1, 17, 256, 1000})
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        const int count = countAllocations(dynamics, buffer, 8);
+        std::cout << "Test: Block size " << blockSize << " (prepared 256) - allocations: " << count << std::endl;
+        assert(count == 0);
+        
+        for (int i = 0; i < blockSize; ++i)
+            assert(std::isfinite(buffer.getSample(0, i)));
+    }
+}
+
+void testOutputMeter()
+{
+    // Runs after the mixer on every block: reset and odd block sizes included, including a full queue
+    LoudnessMeter meter;
+    meter.prepare(48000.0, 256);
+    juce::Random random(7);
+    
+    allocationCount = 0;
+    for (int b = 0; b < 2000; ++b)
+    {
+        const int blockSize = b % 3 == 0 ? 1000 : 97;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        fillNoise(buffer, random, 0.5f);
+        
+        trackAllocations = true;
+        if (b == 1000)
+            meter.reset();
+        meter.process(buffer.getReadPointer(0), buffer.getReadPointer(1), blockSize);
+        trackAllocations = false;
+    }
+    
+    std::cout << "Test: Output meter - allocations: " << allocationCount.load() << std::endl;
+    assert(allocationCount.load() == 0);
+}
+
+void testVoiceInserts()
+{
+    // Every insert type in both slots, parameters moving each block, blocks longer than
+    // the scratch space, retriggered as the voices die away
+    LowTomVoice voice;
+    voice.prepare(48000.0, 256);
+    voice.prepareInserts(48000.0, 256);
+    juce::AudioBuffer<float> buffer(2, 1000);
+    
+    allocationCount = 0;
+    for (int b = 0; b < 200; ++b)
+    {
+        const float amount = (b % 7) / 7.0f;
+        for (int s = 0; s < VoiceInsertChain::NUM_SLOTS; ++s)
+        {
+            auto& slot = voice.getInserts().getSlot(s);
+            slot.setType((b / 10 + s) % (VoiceInsert::Bitcrusher + 1));
+            slot.setParameters(amount, 1.0f - amount, 0.5f);
+        }
+        buffer.clear();
+        
+        trackAllocations = true;
+        if (b % 20 == 0)
+            voice.trigger(1.0f);
+        voice.renderWithInserts(buffer, 0, 1000);
+        trackAllocations = false;
+    }
+    
+    std::cout << "Test: Voice inserts - allocations: " << allocationCount.load() << std::endl;
+    assert(allocationCount.load() == 0);
+}
+
+int main()
+{
+    std::cout << "=== MasterDynamics Allocation Tests ===" << std::endl;
+    
+    testNoAllocationsInProcess();
+    testSmallAndOversizedBlocks();
+    testOutputMeter();
+    testVoiceInserts();
+    
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -1,7 +1,9 @@
 #include "../../../Source/MasterDynamics.h"
 #include <cassert>
 #include <cmath>
+#include <complex>
 #include <iostream>
+#include <vector>
 
 void testNoBoundedOutput()
 {
@@ -135,6 +137,115 @@ void testOversamplingModes()
     }
 }
 
+// In-place radix-2 FFT
+static void fft(std::vector<std::complex<double>>& a)
+{
+    const size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        const std::complex<double> w = std::polar(1.0, -juce::MathConstants<double>::twoPi / static_cast<double>(len));
+        for (size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> wk = 1.0;
+            for (size_t k = 0; k < len / 2; ++k, wk *= w)
+            {
+                const auto u = a[i + k], v = a[i + k + len / 2] * wk;
+                a[i + k] = u + v;
+                a[i + k + len / 2] = u - v;
+            }
+        }
+    }
+}
+
+// Energy folded back from above Nyquist, relative to the whole output (dB). The tone sits
+// exactly on an FFT bin, so every true harmonic lands on a multiple of that bin and
+// everything else is aliasing.
+static double measureAliasingDb(int oversampling, int antialias, int curve, double frequency)
+{
+    const double sampleRate = 48000.0;
+    const int fftSize = 8192, blockSize = 512, warmUpBlocks = 4;
+    const int bin = static_cast<int>(std::lround(frequency * fftSize / sampleRate));
+    
+    MasterDynamics dynamics;
+    dynamics.prepare(sampleRate, blockSize);
+    dynamics.setClipperDrive(12.0f);
+    dynamics.setClipperOutput(0.0f);
+    dynamics.setClipperMix(100.0f);
+    dynamics.setClipperCurve(curve);
+    dynamics.setClipperAntialias(antialias);
+    dynamics.setClipperOversampling(oversampling);
+    
+    std::vector<std::complex<double>> spectrum;
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    for (int b = 0; b < warmUpBlocks + fftSize / blockSize; ++b)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const int n = b * blockSize + i;
+            const float x = 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * bin * n / fftSize));
+            buffer.setSample(0, i, x);
+            buffer.setSample(1, i, x);
+        }
+        dynamics.process(buffer, false, false, true);
+        if (b >= warmUpBlocks)
+            for (int i = 0; i < blockSize; ++i)
+                spectrum.emplace_back(buffer.getSample(0, i), 0.0);
+    }
+    
+    fft(spectrum);
+    
+    double total = 0.0, aliased = 0.0;
+    for (int k = 1; k < fftSize / 2; ++k)
+    {
+        const double power = std::norm(spectrum[static_cast<size_t>(k)]);
+        total += power;
+        if (k % bin != 0)
+            aliased += power;
+    }
+    return 10.0 * std::log10(aliased / total + 1.0e-30);
+}
+
+void testAdaaAliasing()
+{
+    // Stepped sweep over the upper part of the band, where folded harmonics are worst
+    const double frequencies[] = {2000.0, 4000.0, 7000.0, 10000.0};
+    struct Mode { const char* name; int oversampling, antialias; };
+    const Mode modes[] = {{"1x", 0, 0}, {"1x ADAA1", 0, 1}, {"1x ADAA2", 0, 2},
+                          {"2x", 1, 0}, {"2x ADAA1", 1, 1}, {"2x ADAA2", 1, 2}, {"4x", 2, 0}};
+    const char* curveNames[] = {"Tanh", "Atan", "Poly"};
+    
+    for (int curve = 0; curve < 3; ++curve)
+    {
+        double worst[7];
+        for (int m = 0; m < 7; ++m)
+        {
+            worst[m] = -300.0;
+            for (double f : frequencies)
+                worst[m] = std::max(worst[m], measureAliasingDb(modes[m].oversampling, modes[m].antialias, curve, f));
+        }
+        
+        std::cout << "Test: Aliasing (" << curveNames[curve] << ", worst over sweep, dB):";
+        for (int m = 0; m < 7; ++m)
+            std::cout << " " << modes[m].name << " " << worst[m];
+        std::cout << std::endl;
+        
+        // ADAA at the same rate always helps, and 2x with ADAA2 matches 4x without
+        assert(worst[1] < worst[0] - 6.0);
+        assert(worst[2] < worst[1] - 6.0);
+        assert(worst[4] < worst[3]);
+        assert(worst[5] < worst[6] + 3.0);
+    }
+}
+
 int main()
 {
     std::cout << "=== Soft Clipper Unit Tests ===" << std::endl;
@@ -143,6 +254,7 @@ int main()
     testCurveSelection();
     testParallelMix();
     testOversamplingModes();
+    testAdaaAliasing();
     
     std::cout << "\n✓ All tests passed!" << std::endl;
     return 0;
@@ -1,7 +1,19 @@
 #include "../../../Source/MasterDynamics.h"
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <random>
+#include <vector>
+
+// 1 kHz sine at the given RMS level (the sidechain HPF removes DC, so test tones must be AC)
+static void fillSine(juce::AudioBuffer<float>& buffer, float rmsDb)
+{
+    const float amplitude = juce::Decibels::decibelsToGain(rmsDb) * std::sqrt(2.0f);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(ch, i, amplitude * std::sin(juce::MathConstants<float>::twoPi * 1000.0f * i / 48000.0f));
+}
 
 void testBasicGainReduction()
 {
@@ -21,14 +33,10 @@ void testBasicGainReduction()
     
     // Create test buffer: -6dB signal (6dB over threshold)
     juce::AudioBuffer<float> buffer(2, 512);
-    float testLevel = juce::Decibels::decibelsToGain(-6.0f);
-    
-    for (int ch = 0; ch < 2; ++ch)
-        for (int i = 0; i < 512; ++i)
-            buffer.setSample(ch, i, testLevel);
+    fillSine(buffer, -6.0f);
     
     // Process
-    comp.process(buffer, true, false);
+    comp.process(buffer, true, false, false);
     
     // Expected GR: (levelDb - threshold) * (1 - 1/ratio)
     // (-6 - (-12)) * (1 - 1/4) = 6 * 0.75 = 4.5 dB
@@ -55,13 +63,9 @@ void testSoftKnee()
     
     // Signal at threshold (should have minimal GR with soft knee)
     juce::AudioBuffer<float> buffer(2, 512);
-    float testLevel = juce::Decibels::decibelsToGain(-12.0f);
-    
-    for (int ch = 0; ch < 2; ++ch)
-        for (int i = 0; i < 512; ++i)
-            buffer.setSample(ch, i, testLevel);
+    fillSine(buffer, -12.0f);
     
-    comp.process(buffer, true, false);
+    comp.process(buffer, true, false, false);
     float gr = comp.getGainReduction();
     
     std::cout << "Test: Soft Knee - Expected minimal GR at threshold, Got: " << gr << "dB" << std::endl;
@@ -85,13 +89,9 @@ void testNoCompressionBelowThreshold()
     
     // Signal below threshold
     juce::AudioBuffer<float> buffer(2, 512);
-    float testLevel = juce::Decibels::decibelsToGain(-24.0f);
-    
-    for (int ch = 0; ch < 2; ++ch)
-        for (int i = 0; i < 512; ++i)
-            buffer.setSample(ch, i, testLevel);
+    fillSine(buffer, -24.0f);
     
-    comp.process(buffer, true, false);
+    comp.process(buffer, true, false, false);
     float gr = comp.getGainReduction();
     
     std::cout << "Test: Below Threshold - Expected ~0dB GR, Got: " << gr << "dB" << std::endl;
@@ -114,7 +114,6 @@ void testRatioSteps()
     
     // Test different ratios
     const float ratios[] = {1.0f, 2.0f, 4.0f, 8.0f, 10.0f, 20.0f, 100.0f};
-    float testLevel = juce::Decibels::decibelsToGain(-6.0f); // 6dB over threshold
     
     for (float ratio : ratios)
     {
@@ -122,11 +121,9 @@ void testRatioSteps()
         comp.setRatio(ratio);
         
         juce::AudioBuffer<float> buffer(2, 512);
-        for (int ch = 0; ch < 2; ++ch)
-            for (int i = 0; i < 512; ++i)
-                buffer.setSample(ch, i, testLevel);
+        fillSine(buffer, -6.0f); // 6dB over threshold
         
-        comp.process(buffer, true, false);
+        comp.process(buffer, true, false, false);
         float gr = comp.getGainReduction();
         
         std::cout << "Test: Ratio " << ratio << ":1 - GR: " << gr << "dB" << std::endl;
@@ -136,6 +133,313 @@ void testRatioSteps()
     }
 }
 
+static void configureLinkTest(MasterDynamics& comp, int linkMode)
+{
+    comp.prepare(48000.0, 512);
+    comp.setThreshold(-20.0f);
+    comp.setRatio(4.0f);
+    comp.setAttack(1.0f);
+    comp.setRelease(50.0f);
+    comp.setKnee(0.0f);
+    comp.setMakeup(0.0f);
+    comp.setAutoMakeup(false);
+    comp.setDetectorMode(true);
+    comp.setLookahead(0.0f);
+    comp.setLinkMode(linkMode);
+}
+
+// Runs 8 blocks of a 1 kHz tone with per-channel gains, returns the output RMS of each channel in dB
+static std::array<float, 2> renderLinkTest(MasterDynamics& comp, float leftGain, float rightGain)
+{
+    juce::AudioBuffer<float> buffer(2, 512);
+    std::array<double, 2> sum{};
+    for (int b = 0; b < 8; ++b)
+    {
+        for (int i = 0; i < 512; ++i)
+        {
+            const float x = 0.5f * std::sin(juce::MathConstants<float>::twoPi * 1000.0f * (b * 512 + i) / 48000.0f);
+            buffer.setSample(0, i, leftGain * x);
+            buffer.setSample(1, i, rightGain * x);
+        }
+        comp.process(buffer, true, false, false);
+        if (b == 7)
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 512; ++i)
+                    sum[static_cast<size_t>(ch)] += buffer.getSample(ch, i) * buffer.getSample(ch, i);
+    }
+    return {juce::Decibels::gainToDecibels(static_cast<float>(std::sqrt(sum[0] / 512.0)), -200.0f),
+            juce::Decibels::gainToDecibels(static_cast<float>(std::sqrt(sum[1] / 512.0)), -200.0f)};
+}
+
+void testLinkModes()
+{
+    // Loud left (-9 dB RMS), quiet right (-33 dB RMS); threshold -20 dB
+    const float quiet = 1.0f / 16.0f;
+    const float inputLeft = juce::Decibels::gainToDecibels(0.5f / std::sqrt(2.0f));
+    const float inputRight = inputLeft + juce::Decibels::gainToDecibels(quiet);
+    std::array<std::array<float, 2>, 4> out;
+    
+    for (int mode = 0; mode < 4; ++mode)
+    {
+        MasterDynamics comp;
+        configureLinkTest(comp, mode);
+        out[static_cast<size_t>(mode)] = renderLinkTest(comp, 1.0f, quiet);
+        std::cout << "Test: Link mode " << mode << " - L " << out[static_cast<size_t>(mode)][0] - inputLeft
+                  << " dB, R " << out[static_cast<size_t>(mode)][1] - inputRight << " dB" << std::endl;
+    }
+    
+    const auto& maxLinked = out[MasterDynamics::MaxLinked];
+    const auto& unlinked = out[MasterDynamics::Unlinked];
+    const auto& monoSum = out[MasterDynamics::MonoSum];
+    
+    // Max-linked: both channels get the loud channel's gain, the image is preserved
+    assert(maxLinked[0] - inputLeft < -6.0f);
+    assert(std::abs((maxLinked[0] - inputLeft) - (maxLinked[1] - inputRight)) < 0.1f);
+    
+    // Unlinked: the loud channel is compressed as much, the quiet one (below threshold) is left alone
+    assert(std::abs(unlinked[0] - maxLinked[0]) < 0.5f);
+    assert(std::abs(unlinked[1] - inputRight) < 0.1f);
+    
+    // Mono sum sees the average, so it compresses less than max-linked but still linked
+    assert(monoSum[0] > maxLinked[0] + 1.0f);
+    assert(std::abs((monoSum[0] - inputLeft) - (monoSum[1] - inputRight)) < 0.1f);
+}
+
+void testMidSide()
+{
+    // Identical channels: no side signal, so M/S compresses the mid exactly like max-linked
+    MasterDynamics ms, linked;
+    configureLinkTest(ms, MasterDynamics::MidSide);
+    configureLinkTest(linked, MasterDynamics::MaxLinked);
+    const auto centre = renderLinkTest(ms, 1.0f, 1.0f);
+    const auto centreLinked = renderLinkTest(linked, 1.0f, 1.0f);
+    std::cout << "Test: Mid/Side centred - " << centre[0] << " dB vs linked " << centreLinked[0] << " dB" << std::endl;
+    assert(std::abs(centre[0] - centreLinked[0]) < 0.1f && std::abs(centre[0] - centre[1]) < 0.01f);
+    
+    // Loud side, quiet mid: only the side is compressed. With L = M + gS and R = M - gS
+    // the RMS difference between the channels stays 2M whatever the side gain g is
+    MasterDynamics wide;
+    configureLinkTest(wide, MasterDynamics::MidSide);
+    const auto out = renderLinkTest(wide, 1.0f, -0.875f); // M = 1/16, S = 15/16 of the tone
+    const float toneRms = 0.5f / std::sqrt(2.0f);
+    const float difference = juce::Decibels::decibelsToGain(out[0]) - juce::Decibels::decibelsToGain(out[1]);
+    std::cout << "Test: Mid/Side wide - L " << out[0] << " dB, R " << out[1] << " dB, L-R "
+              << difference / toneRms << " (expected 0.125)" << std::endl;
+    assert(out[0] < juce::Decibels::gainToDecibels(toneRms) - 6.0f);
+    assert(std::abs(difference / toneRms - 0.125f) < 0.005f);
+}
+
+void testParallelMix()
+{
+    // Heavy "crush" settings with lookahead, so the dry path has to be delayed to line up
+    const int blockSize = 512, numBlocks = 8;
+    std::vector<float> input(static_cast<size_t>(blockSize * numBlocks));
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> noise(-0.2f, 0.2f);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = 0.6f * std::sin(0.07f * static_cast<float>(i)) * std::exp(-0.002f * static_cast<float>(i % 2000)) + noise(rng);
+    
+    auto render = [&](float mixPercent, int& latency)
+    {
+        MasterDynamics comp;
+        comp.prepare(48000.0, blockSize);
+        comp.setThreshold(-30.0f);
+        comp.setRatio(10.0f);
+        comp.setAttack(0.5f);
+        comp.setRelease(80.0f);
+        comp.setKnee(0.0f);
+        comp.setMakeup(6.0f);
+        comp.setLookahead(2.0f);
+        comp.setMix(mixPercent);
+        latency = comp.getLatencySamples(true, false, false);
+        
+        std::vector<float> output;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, input[static_cast<size_t>(b * blockSize + i)]);
+            comp.process(buffer, true, false, false);
+            for (int i = 0; i < blockSize; ++i)
+                output.push_back(buffer.getSample(0, i));
+        }
+        return output;
+    };
+    
+    int latency = 0;
+    const auto wet = render(100.0f, latency);
+    const auto dry = render(0.0f, latency);
+    const auto half = render(50.0f, latency);
+    assert(latency > 0);
+    
+    // Mix 0 is the input delayed by exactly the reported latency (once the mix ramp is done)
+    float dryError = 0.0f, blendError = 0.0f, wetDifference = 0.0f;
+    for (size_t i = static_cast<size_t>(2 * blockSize); i < input.size(); ++i)
+    {
+        dryError = std::max(dryError, std::abs(dry[i] - input[i - static_cast<size_t>(latency)]));
+        wetDifference = std::max(wetDifference, std::abs(wet[i] - dry[i]));
+    }
+    
+    // The blend is linear in the mix, ramps included: 50% is the average of 0% and 100%
+    for (size_t i = 0; i < input.size(); ++i)
+        blendError = std::max(blendError, std::abs(half[i] - 0.5f * (dry[i] + wet[i])));
+    
+    std::cout << "Test: Parallel mix - dry path error " << dryError << ", blend error " << blendError
+              << ", max wet/dry difference " << wetDifference << std::endl;
+    assert(dryError < 1.0e-6f);
+    assert(blendError < 1.0e-5f);
+    assert(wetDifference > 0.1f); // the compressed copy really is different
+}
+
+// Amplitude of one frequency in a signal (single-bin DFT)
+static float toneAmplitude(const std::vector<float>& x, double freq)
+{
+    double re = 0.0, im = 0.0;
+    for (size_t n = 0; n < x.size(); ++n)
+    {
+        const double phase = juce::MathConstants<double>::twoPi * freq * static_cast<double>(n) / 48000.0;
+        re += x[n] * std::cos(phase);
+        im -= x[n] * std::sin(phase);
+    }
+    return static_cast<float>(2.0 * std::sqrt(re * re + im * im) / static_cast<double>(x.size()));
+}
+
+void testMultibandIsolation()
+{
+    // Loud low tone (the "kick") plus quiet 8 kHz tone (the "hats"), hats well below threshold
+    const float lowAmp = 0.8f, hatAmp = 0.05f;
+    float hatLevel[2] = {}, lowLevel[2] = {}, bandGr[3] = {};
+    
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        MasterDynamics comp;
+        comp.prepare(48000.0, 480);
+        comp.setThreshold(-20.0f);
+        comp.setRatio(8.0f);
+        comp.setAttack(1.0f);
+        comp.setRelease(50.0f);
+        comp.setKnee(0.0f);
+        comp.setScHpfFreq(20.0f);
+        comp.setBandMode(mode == 0 ? MasterDynamics::SingleBand : MasterDynamics::ThreeBand);
+        comp.setCrossoverFrequencies(150.0f, 4000.0f);
+        
+        juce::AudioBuffer<float> buffer(2, 480);
+        std::vector<float> output;
+        for (int b = 0; b < 40; ++b)
+        {
+            for (int i = 0; i < 480; ++i)
+            {
+                const float t = static_cast<float>(b * 480 + i) / 48000.0f;
+                const float x = lowAmp * std::sin(juce::MathConstants<float>::twoPi * 60.0f * t)
+                              + hatAmp * std::sin(juce::MathConstants<float>::twoPi * 8000.0f * t);
+                buffer.setSample(0, i, x);
+                buffer.setSample(1, i, x);
+            }
+            comp.process(buffer, true, false, false);
+            if (b >= 20) // 0.2 s settled, whole number of cycles of both tones
+                for (int i = 0; i < 480; ++i)
+                    output.push_back(buffer.getSample(0, i));
+        }
+        
+        hatLevel[mode] = juce::Decibels::gainToDecibels(toneAmplitude(output, 8000.0) / hatAmp);
+        lowLevel[mode] = juce::Decibels::gainToDecibels(toneAmplitude(output, 60.0) / lowAmp);
+        if (mode == 1)
+            for (int band = 0; band < 3; ++band)
+                bandGr[band] = comp.getBandGainReduction(band);
+        
+        std::cout << "Test: " << (mode == 0 ? "Single band" : "3-band") << " - low tone " << lowLevel[mode]
+                  << " dB, 8 kHz tone " << hatLevel[mode] << " dB" << std::endl;
+    }
+    
+    std::cout << "Test: 3-band GR - low " << bandGr[0] << " dB, mid " << bandGr[1] << " dB, high " << bandGr[2] << " dB" << std::endl;
+    
+    // Single band: the low tone pulls the hats down with it
+    assert(lowLevel[0] < -6.0f && hatLevel[0] < -6.0f);
+    
+    // 3-band: the low band is compressed just as hard, the hats are left alone
+    assert(lowLevel[1] < -6.0f);
+    assert(std::abs(hatLevel[1]) < 0.5f);
+    assert(bandGr[0] < -6.0f && bandGr[2] > -0.5f);
+}
+
+void testMultibandTransparentBelowThreshold()
+{
+    // Below threshold the bands only recombine: the output is the input through an allpass,
+    // so its level per frequency is unchanged
+    MasterDynamics comp;
+    comp.prepare(48000.0, 480);
+    comp.setThreshold(0.0f);
+    comp.setBandMode(MasterDynamics::ThreeBand);
+    
+    juce::AudioBuffer<float> buffer(2, 480);
+    std::vector<float> output;
+    const float freqs[] = {50.0f, 150.0f, 1000.0f, 4000.0f, 12000.0f};
+    for (int b = 0; b < 30; ++b)
+    {
+        for (int i = 0; i < 480; ++i)
+        {
+            const float t = static_cast<float>(b * 480 + i) / 48000.0f;
+            float x = 0.0f;
+            for (float f : freqs)
+                x += 0.05f * std::sin(juce::MathConstants<float>::twoPi * f * t);
+            buffer.setSample(0, i, x);
+            buffer.setSample(1, i, x);
+        }
+        comp.process(buffer, true, false, false);
+        if (b >= 10)
+            for (int i = 0; i < 480; ++i)
+                output.push_back(buffer.getSample(0, i));
+    }
+    
+    float worst = 0.0f;
+    for (float f : freqs)
+        worst = std::max(worst, std::abs(juce::Decibels::gainToDecibels(toneAmplitude(output, f) / 0.05f)));
+    std::cout << "Test: 3-band below threshold - max level change " << worst << " dB" << std::endl;
+    assert(worst < 0.05f);
+}
+
+void testRmsDetector()
+{
+    // Sliding window must match a brute-force sum over the same window
+    const int window = 480;
+    RmsDetector detector;
+    detector.prepare(window);
+    
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> history;
+    float maxError = 0.0f;
+    
+    for (int i = 0; i < 20000; ++i)
+    {
+        const float x = dist(rng);
+        history.push_back(x * x);
+        const float meanSquare = detector.process(x * x);
+        
+        if (i % 997 == 0 && i >= window)
+        {
+            double sum = 0.0;
+            for (int j = i - window + 1; j <= i; ++j)
+                sum += history[static_cast<size_t>(j)];
+            maxError = std::max(maxError, std::abs(meanSquare - static_cast<float>(sum / window)));
+        }
+    }
+    
+    std::cout << "Test: RMS window vs brute force - max error " << maxError << std::endl;
+    assert(maxError < 1.0e-5f);
+    
+    // Smooth mode settles to the same steady-state level
+    detector.setMode(RmsDetector::Smooth);
+    detector.reset();
+    float meanSquare = 0.0f;
+    for (int i = 0; i < 48000; ++i)
+        meanSquare = detector.process(0.25f);
+    assert(std::abs(meanSquare - 0.25f) < 1.0e-4f);
+    
+    std::cout << "Test: RMS smooth mode steady state - Passed" << std::endl;
+}
+
 int main()
 {
     std::cout << "=== MasterDynamics Compressor Unit Tests ===" << std::endl;
@@ -144,6 +448,12 @@ int main()
     testSoftKnee();
     testNoCompressionBelowThreshold();
     testRatioSteps();
+    testLinkModes();
+    testMidSide();
+    testParallelMix();
+    testMultibandIsolation();
+    testMultibandTransparentBelowThreshold();
+    testRmsDetector();
     
     std::cout << "\n✓ All tests passed!" << std::endl;
     return 0;
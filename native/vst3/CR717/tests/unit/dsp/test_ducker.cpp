@@ -0,0 +1,85 @@
+#include "../../../Source/Ducker.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+// The gain curve over numSamples, rendered in blocks, with one trigger at sample time
+static std::vector<float> render(int blockSize, int time, int numSamples)
+{
+    TriggerDucker ducker;
+    ducker.prepare(48000.0, blockSize);
+    ducker.setDepth(-12.0f);
+    ducker.setAttack(1.0f);
+    ducker.setRelease(50.0f);
+
+    std::vector<float> curve;
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        const int n = std::min(blockSize, numSamples - start);
+        if (time >= start && time < start + n)
+            ducker.addTrigger(time - start, 1.0f);
+        ducker.renderGain(n);
+        curve.insert(curve.end(), ducker.getGainCurve(), ducker.getGainCurve() + n);
+    }
+    return curve;
+}
+
+void testDuckStartsOnTheTrigger()
+{
+    // Offsets at either end of a block and in the middle, for every block size
+    for (int blockSize : {1, 7, 64, 100, 512})
+    {
+        for (int time : {0, 1, 63, 64, 333, 511, 512, 1000})
+        {
+            const auto curve = render(blockSize, time, 2048);
+            for (int i = 0; i < time; ++i)
+                assert(curve[static_cast<size_t>(i)] == 1.0f);
+            assert(curve[static_cast<size_t>(time)] < 1.0f);
+        }
+    }
+
+    std::cout << "Test: Duck starts on the trigger sample - Passed" << std::endl;
+}
+
+void testBlockSizeIndependent()
+{
+    // The same trigger time gives the same curve whichever block it falls in
+    const auto reference = render(2048, 777, 2048);
+    for (int blockSize : {1, 13, 128, 777, 778})
+        assert(render(blockSize, 777, 2048) == reference);
+
+    std::cout << "Test: Gain curve independent of block size - Passed" << std::endl;
+}
+
+void testOutOfOrderTriggers()
+{
+    // MIDI and sequencer triggers arrive unsorted; each still lands on its own sample
+    TriggerDucker ducker;
+    ducker.prepare(48000.0, 256);
+    ducker.setDepth(-12.0f);
+    ducker.setAttack(1.0f);
+    ducker.addTrigger(200, 0.5f);
+    ducker.addTrigger(40, 0.5f);
+    ducker.renderGain(256);
+
+    const float* gain = ducker.getGainCurve();
+    for (int i = 0; i < 40; ++i)
+        assert(gain[i] == 1.0f);
+    assert(gain[40] < 1.0f);
+    assert(gain[200] < gain[199]); // released a little by then, ducks again
+
+    std::cout << "Test: Out-of-order triggers - Passed" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== Trigger Ducker Tests ===" << std::endl;
+
+    testDuckStartsOnTheTrigger();
+    testBlockSizeIndependent();
+    testOutOfOrderTriggers();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
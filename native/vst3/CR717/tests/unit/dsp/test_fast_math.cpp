@@ -0,0 +1,94 @@
+#include "../../../Source/ClipCurves.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Documented error bounds (max over the tested range):
+//   tanh            |err| < 1e-4         (all x; exactly +-1 from |x| = 5)
+//   atan            |err| < 5e-7         (all x)
+//   log2            |err| < 2e-6         (1e-5 .. 1e4)
+//   exp2            rel err < 5e-6       (-100 .. 40)
+//   gainToDecibels  |err| < 2e-5 dB      (1e-5 .. 1e4, -100 dB floor as juce::Decibels)
+//   decibelsToGain  rel err < 5e-6       (-99 .. 40 dB, 0 at -100 dB and below)
+
+void testCurves()
+{
+    double tanhError = 0.0, atanError = 0.0;
+    for (double x = -10.0; x <= 10.0; x += 1.0e-4)
+    {
+        tanhError = std::max(tanhError, std::abs(FastMath::tanh(static_cast<float>(x)) - std::tanh(x)));
+        atanError = std::max(atanError, std::abs(FastMath::atan(static_cast<float>(x)) - std::atan(x)));
+    }
+    for (double x = 10.0; x < 1.0e6; x *= 1.01)
+        atanError = std::max(atanError, std::abs(FastMath::atan(static_cast<float>(x)) - std::atan(x)));
+    
+    std::cout << "Test: tanh max error " << tanhError << ", atan max error " << atanError << std::endl;
+    assert(tanhError < 1.0e-4);
+    assert(atanError < 5.0e-7);
+    assert(FastMath::tanh(50.0f) == 1.0f && FastMath::tanh(-50.0f) == -1.0f);
+}
+
+void testLogExp()
+{
+    double logError = 0.0, dbError = 0.0;
+    for (double x = 1.0e-5; x <= 1.0e4; x *= 1.0001)
+    {
+        logError = std::max(logError, std::abs(FastMath::log2(static_cast<float>(x)) - std::log2(x)));
+        dbError = std::max(dbError, std::abs(FastMath::gainToDecibels(static_cast<float>(x)) - 20.0 * std::log10(x)));
+    }
+    
+    double expError = 0.0, gainError = 0.0;
+    for (double x = -100.0; x <= 40.0; x += 1.0e-3)
+        expError = std::max(expError, std::abs(FastMath::exp2(static_cast<float>(x)) / std::exp2(x) - 1.0));
+    for (double db = -99.0; db <= 40.0; db += 1.0e-3)
+        gainError = std::max(gainError, std::abs(FastMath::decibelsToGain(static_cast<float>(db)) / std::pow(10.0, db / 20.0) - 1.0));
+    
+    std::cout << "Test: log2 " << logError << ", exp2 (rel) " << expError
+              << ", gainToDecibels " << dbError << " dB, decibelsToGain (rel) " << gainError << std::endl;
+    assert(logError < 2.0e-6);
+    assert(expError < 5.0e-6);
+    assert(dbError < 2.0e-5);
+    assert(gainError < 5.0e-6);
+    
+    // Same edge behaviour as juce::Decibels
+    assert(FastMath::gainToDecibels(0.0f) == -100.0f);
+    assert(FastMath::decibelsToGain(-100.0f) == 0.0f);
+}
+
+void testBlockKernels()
+{
+    // The templated block kernels against the double-precision reference curves
+    std::vector<float> block(1024);
+    for (int curve = 0; curve < 3; ++curve)
+    {
+        for (size_t i = 0; i < block.size(); ++i)
+            block[i] = -3.0f + 6.0f * static_cast<float>(i) / static_cast<float>(block.size());
+        const std::vector<float> input = block;
+        
+        ClipCurves::processBlock(curve, block.data(), static_cast<int>(block.size()), 2.0f, 0.5f, 0.75f);
+        
+        double maxError = 0.0;
+        for (size_t i = 0; i < block.size(); ++i)
+        {
+            const double dry = input[i];
+            const double expected = dry + 0.75 * (0.5 * ClipCurves::f(curve, 2.0 * dry) - dry);
+            maxError = std::max(maxError, std::abs(block[i] - expected));
+        }
+        
+        std::cout << "Test: Block kernel, curve " << curve << " max error " << maxError << std::endl;
+        assert(maxError < 1.0e-4);
+    }
+}
+
+int main()
+{
+    std::cout << "=== Fast Math Unit Tests ===" << std::endl;
+    
+    testCurves();
+    testLogExp();
+    testBlockKernels();
+    
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,267 @@
+#include "../../../Source/FxGraph.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Nodes that record the order they ran in and tag the bus they were given
+struct Recorder
+{
+    std::vector<int> order;
+
+    void install(FxGraph& graph)
+    {
+        for (int n = 0; n < FxGraph::NUM_NODES; ++n)
+        {
+            graph.setNode(static_cast<FxGraph::Node>(n), [this, n](juce::AudioBuffer<float>& bus, int numSamples)
+            {
+                order.push_back(n);
+                if (n == FxGraph::ReverbNode || n == FxGraph::DelayNode)
+                    for (int ch = 0; ch < 2; ++ch)
+                        bus.applyGain(ch, 0, numSamples, 2.0f); // "wet" = twice the send
+            });
+        }
+    }
+};
+
+void testDefaultRouting()
+{
+    FxGraph graph;
+    Recorder recorder;
+    recorder.install(graph);
+    
+    juce::AudioBuffer<float> main(2, 64), sendA(2, 64), sendB(2, 64);
+    graph.prepare(sendA, sendB, 64);
+    graph.publish(FxRouting{}.compile());
+    graph.setGain(FxGraph::ReverbWet, 0.5f);
+    graph.setGain(FxGraph::DelayWet, 0.25f);
+    
+    main.clear();
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 64; ++i)
+        {
+            sendA.setSample(ch, i, 1.0f);
+            sendB.setSample(ch, i, 1.0f);
+        }
+    
+    graph.process(main, 64);
+    
+    // main = 2 * 0.5 + 2 * 0.25
+    assert(std::abs(main.getSample(0, 10) - 1.5f) < 1.0e-6f);
+    
+    const std::vector<int> expected = {FxGraph::ReverbNode, FxGraph::DuckReverbNode, FxGraph::DelayNode, FxGraph::DuckDelayNode,
+                                       FxGraph::CompressorNode, FxGraph::ClipLimitNode};
+    assert(recorder.order == expected);
+    
+    std::cout << "Test: Default routing - Passed" << std::endl;
+}
+
+void testReorderAndChain()
+{
+    FxGraph graph;
+    Recorder recorder;
+    recorder.install(graph);
+    
+    juce::AudioBuffer<float> main(2, 64), sendA(2, 64), sendB(2, 64);
+    graph.prepare(sendA, sendB, 64);
+    graph.publish(FxRouting{}.compile());
+    
+    // Several publishes between blocks: only the latest is picked up
+    FxRouting routing;
+    routing.sendChain = FxRouting::ReverbIntoDelay;
+    graph.publish(routing.compile());
+    routing.masterOrder = FxRouting::ClipCompLimit;
+    graph.publish(routing.compile());
+    
+    main.clear();
+    sendB.clear();
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 64; ++i)
+            sendA.setSample(ch, i, 1.0f);
+    
+    graph.setGain(FxGraph::ReverbWet, 1.0f);
+    graph.setGain(FxGraph::DelayWet, 1.0f);
+    graph.process(main, 64);
+    
+    // Reverb return (2) plus the delay of the reverb return (4)
+    assert(std::abs(main.getSample(1, 0) - 6.0f) < 1.0e-6f);
+    assert(recorder.order[4] == FxGraph::ClipperNode && recorder.order[5] == FxGraph::CompressorNode);
+    assert(recorder.order[6] == FxGraph::LimiterNode);
+    
+    std::cout << "Test: Chained sends, reordered master - Passed" << std::endl;
+}
+
+void testPostCompressorReturns()
+{
+    FxGraph graph;
+    juce::AudioBuffer<float> main(2, 64), sendA(2, 64), sendB(2, 64);
+    graph.prepare(sendA, sendB, 64);
+    
+    // Compressor node zeroes its input: returns that enter after it must survive
+    graph.setNode(FxGraph::CompressorNode, [](juce::AudioBuffer<float>& bus, int numSamples)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            bus.clear(ch, 0, numSamples);
+    });
+    
+    FxRouting routing;
+    routing.returnPoint = FxRouting::PostCompressor;
+    graph.publish(routing.compile());
+    
+    main.clear();
+    sendB.clear();
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 64; ++i)
+        {
+            main.setSample(ch, i, 1.0f);
+            sendA.setSample(ch, i, 0.5f);
+        }
+    
+    graph.setGain(FxGraph::ReverbWet, 1.0f);
+    graph.process(main, 64);
+    
+    assert(std::abs(main.getSample(0, 32) - 0.5f) < 1.0e-6f);
+    
+    std::cout << "Test: Post-compressor returns - Passed" << std::endl;
+}
+
+// A latent stage: delays its bus by a whole number of samples, across blocks
+struct LatentStage
+{
+    int samples = 0;
+    std::vector<float> history[2];
+
+    FxGraph::NodeCallback callback()
+    {
+        return [this](juce::AudioBuffer<float>& bus, int numSamples)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                auto& h = history[ch];
+                for (int i = 0; i < numSamples; ++i)
+                    h.push_back(bus.getSample(ch, i));
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const int n = static_cast<int>(h.size()) - numSamples + i - samples;
+                    bus.setSample(ch, i, n >= 0 ? h[static_cast<size_t>(n)] : 0.0f);
+                }
+            }
+        };
+    }
+};
+
+void testPostCompressorReturnsLineUp()
+{
+    // Compressor lookahead of 3 samples, clipper oversampling of 2: an impulse on the
+    // master and on the send must leave the graph on the same sample, in either order
+    for (int order : {FxRouting::CompClipLimit, FxRouting::ClipCompLimit})
+    {
+        FxGraph graph;
+        LatentStage compressor, clipper;
+        compressor.samples = 3;
+        clipper.samples = 2;
+        graph.setNode(FxGraph::CompressorNode, compressor.callback());
+        graph.setNode(FxGraph::ClipperNode, clipper.callback());
+
+        juce::AudioBuffer<float> main(2, 64), sendA(2, 64), sendB(2, 64);
+        graph.prepare(sendA, sendB, 64, 16);
+        FxRouting routing;
+        routing.returnPoint = FxRouting::PostCompressor;
+        routing.masterOrder = order;
+        graph.publish(routing.compile());
+        graph.setGain(FxGraph::ReverbWet, 1.0f);
+        graph.setReturnDelay(order == FxRouting::ClipCompLimit ? 5 : 3);
+
+        // The impulse goes in near the end of the first block, so it comes out in the second
+        std::vector<float> out;
+        for (int block = 0; block < 2; ++block)
+        {
+            main.clear();
+            sendA.clear();
+            sendB.clear();
+            if (block == 0)
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    main.setSample(ch, 62, 1.0f);
+                    sendA.setSample(ch, 62, 1.0f);
+                }
+            graph.process(main, 64);
+            for (int i = 0; i < 64; ++i)
+                out.push_back(main.getSample(1, i));
+        }
+
+        const int expected = 62 + (order == FxRouting::ClipCompLimit ? 5 : 3);
+        for (int i = 0; i < static_cast<int>(out.size()); ++i)
+            assert(out[static_cast<size_t>(i)] == (i == expected ? 2.0f : 0.0f));
+    }
+
+    std::cout << "Test: Post-compressor returns line up - Passed" << std::endl;
+}
+
+void testBlockRunsTheAcquiredProgram()
+{
+    // The processor sets the return delay from the program it acquired; a routing published
+    // after that (mid-block) must wait for the next block, or the delay would be for a
+    // chain that isn't running
+    for (int chain = 0; chain < 3; ++chain)
+        for (int order = 0; order < 2; ++order)
+            for (int point = 0; point < 2; ++point)
+            {
+                FxRouting routing;
+                routing.sendChain = chain;
+                routing.masterOrder = order;
+                routing.returnPoint = point;
+                assert(FxRouting::fromKey(routing.compile().routingKey).getKey() == routing.getKey());
+            }
+
+    FxGraph graph;
+    LatentStage compressor, clipper;
+    compressor.samples = 3;
+    clipper.samples = 2;
+    graph.setNode(FxGraph::CompressorNode, compressor.callback());
+    graph.setNode(FxGraph::ClipperNode, clipper.callback());
+    juce::AudioBuffer<float> main(2, 64), sendA(2, 64), sendB(2, 64);
+    graph.prepare(sendA, sendB, 64, 16);
+    graph.setGain(FxGraph::ReverbWet, 1.0f);
+
+    FxRouting compFirst, clipFirst;
+    compFirst.returnPoint = clipFirst.returnPoint = FxRouting::PostCompressor;
+    clipFirst.masterOrder = FxRouting::ClipCompLimit;
+    graph.publish(compFirst.compile());
+
+    const auto running = FxRouting::fromKey(graph.acquire().routingKey);
+    assert(running.clipperFeedsLimiter());
+    graph.publish(clipFirst.compile()); // lands mid-block
+    graph.setReturnDelay(3);            // the compressor alone, as acquired
+
+    main.clear();
+    sendA.clear();
+    sendB.clear();
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        main.setSample(ch, 10, 1.0f);
+        sendA.setSample(ch, 10, 1.0f);
+    }
+    graph.process(main, 64);
+    for (int i = 0; i < 64; ++i)
+        assert(main.getSample(0, i) == (i == 13 ? 2.0f : 0.0f));
+
+    // The next block picks the new order up
+    assert(!FxRouting::fromKey(graph.acquire().routingKey).clipperFeedsLimiter());
+
+    std::cout << "Test: Block runs the program it acquired - Passed" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== FX Graph Unit Tests ===" << std::endl;
+    
+    testDefaultRouting();
+    testReorderAndChain();
+    testPostCompressorReturns();
+    testPostCompressorReturnsLineUp();
+    testBlockRunsTheAcquiredProgram();
+    
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
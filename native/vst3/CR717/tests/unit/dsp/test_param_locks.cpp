@@ -0,0 +1,151 @@
+#include "sequencer_test_helpers.h"
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+void testLockTable()
+{
+    Sequencer::Pattern pattern;
+    pattern.setStep(1, 4, true);
+    assert(pattern.setLock(1, 4, Voice::Decay, 0.9f));
+    assert(pattern.setLock(1, 4, Voice::Tune, 5.0f));
+    assert(pattern.setLock(0, 4, Voice::Tune, -3.0f));
+    assert(pattern.setLock(1, 4, Voice::Tune, 7.0f)); // replaces
+    assert(pattern.numLocks == 3);
+
+    // Sorted by (voice, step, param): a step's locks are one run
+    const auto range = pattern.findLocks(1, 4);
+    assert(range.second - range.first == 2);
+    assert(pattern.locks[static_cast<size_t>(range.first)].param == Voice::Tune);
+    assert(pattern.locks[static_cast<size_t>(range.first)].value == 7.0f);
+
+    float value = 0.0f;
+    assert(pattern.getLock(0, 4, Voice::Tune, value) && value == -3.0f);
+    assert(!pattern.getLock(1, 5, Voice::Tune, value));
+
+    // Locks follow rotation within the track, and go when their step is switched off
+    pattern.rotate(1, -6, 16);
+    assert(pattern.getLock(1, 14, Voice::Decay, value) && value == 0.9f && pattern.getStep(1, 14));
+    pattern.setStep(1, 14, false);
+    assert(pattern.findLocks(1, 14).second == pattern.findLocks(1, 14).first && pattern.numLocks == 1);
+    pattern.clearLock(0, 4, Voice::Tune);
+    assert(pattern.numLocks == 0);
+
+    // Full table
+    for (int i = 0; i < Sequencer::Pattern::MAX_LOCKS; ++i)
+        assert(pattern.setLock(i % Sequencer::NUM_VOICES, i / Sequencer::NUM_VOICES, i % 3, 1.0f));
+    assert(!pattern.setLock(11, 63, Voice::Pan, 0.0f));
+    assert(pattern.setLock(0, 0, 0, 2.0f)); // replacing still works
+
+    std::cout << "Test: Sparse lock table - Passed" << std::endl;
+}
+
+void testWholeVoiceEditsClearSteps()
+{
+    // Steps switched off by invert or euclidean lose their locks and trig settings, so
+    // nothing stale comes back when they are switched on again
+    Sequencer::Pattern pattern;
+    pattern.setStep(2, 3, true);
+    pattern.setStep(2, 4, true);
+    for (int step : {3, 4})
+    {
+        pattern.setLock(2, step, Voice::Tune, 5.0f);
+        pattern.setCondition(2, step, Sequencer::Condition::ratio(1, 2));
+        pattern.setProbability(2, step, 25);
+        pattern.setRatchet(2, step, 4);
+        pattern.setMicroTiming(2, step, 0.25f);
+    }
+
+    pattern.invert(2);
+    assert(!pattern.getStep(2, 3) && !pattern.getStep(2, 4));
+    pattern.invert(2);
+    pattern.euclidean(2, 4); // every step on again, then down to 0, 4, 8 and 12
+    pattern.setStep(2, 3, true);
+    pattern.setStep(2, 4, true);
+
+    float value = 0.0f;
+    for (int step : {3, 4})
+    {
+        assert(!pattern.getLock(2, step, Voice::Tune, value));
+        assert(pattern.getCondition(2, step).kind == Sequencer::Condition::Always);
+        assert(pattern.getProbability(2, step) == 100);
+        assert(pattern.getRatchet(2, step).count == 1);
+        assert(pattern.getMicroTiming(2, step) == 0.0f);
+    }
+    assert(pattern.numLocks == 0);
+
+    // A step kept by euclidean keeps its settings; merge never clears anything
+    pattern.setLock(2, 4, Voice::Tune, 5.0f);
+    pattern.setProbability(2, 8, 40);
+    pattern.euclidean(2, 4);
+    pattern.merge(2, std::uint64_t{1} << 1);
+    assert(pattern.getLock(2, 4, Voice::Tune, value) && pattern.getProbability(2, 8) == 40);
+
+    std::cout << "Test: Whole-voice edits clear switched-off steps - Passed" << std::endl;
+}
+
+void testLocksReachTheTrigger()
+{
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    for (int step : {0, 1, 2})
+        sequencer->setStep(1, step, true);
+    sequencer->setLock(1, 1, Voice::Tune, 12.0f);
+    sequencer->setLock(1, 1, Voice::FilterCutoff, 400.0f);
+    sequencer->play();
+
+    int64_t clock = 0;
+    const auto hits = render(*sequencer, 3 * 6000, 500, clock);
+    assert(hits.size() == 3 && hits[0].locks.empty() && hits[2].locks.empty());
+    const auto& locks = hits[1].locks;
+    assert(locks.size() == 2);
+    assert(locks[0].param == Voice::Tune && locks[0].value == 12.0f);
+    assert(locks[1].param == Voice::FilterCutoff && locks[1].value == 400.0f);
+
+    std::cout << "Test: Locks travel with the hit - Passed" << std::endl;
+}
+
+void testVoiceAppliesLocksPerHit()
+{
+    ProbeVoice voice;
+    voice.prepare(48000.0, 512);
+    voice.setTune(2.0f);
+    voice.setDecay(0.5f);
+    voice.setFilterCutoff(1000.0f);
+
+    // A locked hit starts on the locked values, no glide
+    voice.lockParameter(Voice::Tune, 12.0f);
+    voice.lockParameter(Voice::FilterCutoff, 300.0f);
+    voice.trigger(1.0f);
+    assert(voice.startTune() == 12.0f && voice.targetTune() == 12.0f && voice.cutoff() == 300.0f);
+
+    // Host automation while the locked hit rings does not override it
+    voice.setFilterCutoff(2000.0f);
+    assert(voice.cutoff() == 300.0f);
+
+    // The next hit is back on the parameters, jumping from the locked ones
+    voice.trigger(1.0f);
+    assert(voice.startTune() == 2.0f && voice.cutoff() == 2000.0f && voice.startDecay() == 0.5f);
+
+    // Unlocked hits keep the usual parameter smoothing
+    voice.setTune(4.0f);
+    voice.trigger(1.0f);
+    assert(voice.startTune() == 2.0f && voice.targetTune() == 4.0f);
+
+    std::cout << "Test: Voice applies locks for one hit - Passed" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== Parameter Lock Tests ===" << std::endl;
+
+    testLockTable();
+    testWholeVoiceEditsClearSteps();
+    testLocksReachTheTrigger();
+    testVoiceAppliesLocksPerHit();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "sequencer_test_helpers.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static bool near(float a, float b) { return std::abs(a - b) < 1.0e-4f; }
+
+void testRatchetSettings()
+{
+    Sequencer::Pattern pattern;
+    pattern.setStep(7, 2, true);
+    pattern.setRatchet(7, 2, 5, -150, 30);
+    const auto ratchet = pattern.getRatchet(7, 2);
+    assert(ratchet.count == 4 && ratchet.velocityRamp == -100 && ratchet.pitchRamp == 24);
+    pattern.setRatchet(7, 2, 7);
+    assert(pattern.getRatchet(7, 2).count == 6);
+    pattern.setRatchet(7, 2, 0);
+    assert(pattern.getRatchet(7, 2).count == 1);
+
+    // Rotation carries ratchets with their steps, clearing a step drops its ratchet
+    pattern.setRatchet(7, 2, 8);
+    pattern.rotate(7, 3);
+    assert(pattern.getStep(7, 5) && pattern.getRatchet(7, 5).count == 8 && pattern.getRatchet(7, 2).count == 1);
+    pattern.setStep(7, 5, false);
+    assert(pattern.getRatchet(7, 5).count == 1);
+
+    std::cout << "Test: Ratchet settings - Passed" << std::endl;
+}
+
+void testRatchetsCompileToEvents()
+{
+    Sequencer::Pattern pattern;
+    pattern.setStep(7, 0, true);
+    pattern.setRatchet(7, 0, 4, 50); // rolls up to the step's 0.8
+    pattern.setStep(7, 1, true);
+    pattern.setStep(3, 4, true, true);
+    pattern.setRatchet(3, 4, 3, -50, -12); // tom fall: down an octave, fading
+    pattern.setLock(3, 4, Voice::Decay, 0.2f);
+
+    Sequencer::Timeline timeline;
+    Sequencer::Timeline::compile(pattern, 0.0f, timeline);
+
+    const auto& hats = timeline.tracks[7];
+    assert(hats.numEvents == 5);
+    const float rollUp[] = {0.4f, 0.8f * (1.0f - 0.5f * 2.0f / 3.0f), 0.8f * (1.0f - 0.5f / 3.0f), 0.8f};
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto& hit = timeline.event(7, i);
+        assert(hit.tick == i * 240 && hit.step == 0 && near(hit.velocity, rollUp[i]) && hit.transpose == 0.0f);
+    }
+    assert(timeline.event(7, 4).tick == 960 && timeline.event(7, 4).step == 1);
+
+    // Each hit of the roll has the step's locks
+    const auto& toms = timeline.tracks[3];
+    assert(toms.numEvents == 3);
+    const float transpose[] = {0.0f, -6.0f, -12.0f};
+    const float velocity[] = {1.0f, 0.75f, 0.5f};
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto& hit = timeline.event(3, i);
+        assert(hit.tick == 4 * 960 + i * 320 && near(hit.transpose, transpose[i]) && near(hit.velocity, velocity[i]));
+        assert(hit.numLocks == 1 && timeline.locks[hit.firstLock].param == Voice::Decay);
+    }
+
+    // With swing a roll on an even step spans the longer half, up to the swung odd step
+    Sequencer::Timeline::compile(pattern, 0.75f, timeline);
+    assert(timeline.event(7, 3).tick == 3 * 360 && timeline.event(7, 4).tick == 1440);
+
+    std::cout << "Test: Ratchets compile to timeline events - Passed" << std::endl;
+}
+
+void testFullTable()
+{
+    // Every step of every track on, all 8-hit rolls: each step still plays once and the
+    // rolls that fit go in voice order
+    Sequencer::Pattern pattern;
+    for (int voice = 0; voice < Sequencer::NUM_VOICES; ++voice)
+    {
+        pattern.setLength(voice, 64);
+        pattern.setRate(voice, Sequencer::ThirtySecond);
+        for (int step = 0; step < 64; ++step)
+        {
+            pattern.setStep(voice, step, true);
+            pattern.setRatchet(voice, step, 8);
+        }
+    }
+
+    Sequencer::Timeline timeline;
+    Sequencer::Timeline::compile(pattern, 0.0f, timeline);
+    int total = 0;
+    for (int voice = 0; voice < Sequencer::NUM_VOICES; ++voice)
+        total += timeline.tracks[static_cast<size_t>(voice)].numEvents;
+    assert(total == 768 + 7 * 36);
+    assert(timeline.tracks[0].numEvents == 64 + 7 * 36); // 256 spare, 7 more hits per roll
+    assert(timeline.tracks[11].numEvents == 64);
+
+    std::cout << "Test: Full event table - Passed" << std::endl;
+}
+
+void testRatchetPlayback()
+{
+    // 120 BPM at 48k: 6000 samples a 16th, a 4-roll every 1500
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    for (int step = 0; step < Sequencer::NUM_STEPS; ++step)
+    {
+        sequencer->setStep(7, step, true);
+        sequencer->setRatchet(7, step, 4, 0, 3);
+        sequencer->setProbability(7, step, 50);
+    }
+    sequencer->setSeed(42);
+
+    int64_t clock = 0;
+    sequencer->play(0);
+    const auto hits = render(*sequencer, 8 * 16 * 6000, 512, clock);
+
+    // Probability is rolled once per step: a roll plays whole or not at all
+    assert(!hits.empty() && hits.size() % 4 == 0);
+    for (size_t i = 0; i < hits.size(); i += 4)
+    {
+        const int64_t start = hits[i].sampleTime;
+        assert(start % 6000 == 0);
+        for (size_t k = 0; k < 4; ++k)
+            assert(hits[i + k].sampleTime == start + static_cast<int64_t>(k) * 1500 && near(hits[i + k].transpose, static_cast<float>(k)));
+    }
+    std::cout << "Test: Ratchet playback - " << hits.size() / 4 << " of 128 rolls, sample exact" << std::endl;
+    assert(hits.size() / 4 > 32 && hits.size() / 4 < 96);
+}
+
+void testVoiceTransposesOneHit()
+{
+    ProbeVoice voice;
+    voice.prepare(48000.0, 512);
+    voice.setTune(2.0f);
+    voice.trigger(1.0f);
+    assert(voice.startTune() == 0.0f); // glides to the knob as before
+
+    voice.transposeNext(-5.0f);
+    voice.trigger(1.0f);
+    assert(voice.startTune() == -3.0f);
+
+    // On top of a Tune lock
+    voice.lockParameter(Voice::Tune, 7.0f);
+    voice.transposeNext(1.5f);
+    voice.trigger(1.0f);
+    assert(voice.startTune() == 8.5f);
+
+    // Next plain hit is back on the knob, straight away
+    voice.trigger(1.0f);
+    assert(voice.startTune() == 2.0f);
+
+    std::cout << "Test: Voice transposes one hit - Passed" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== Ratchet Tests ===" << std::endl;
+
+    testRatchetSettings();
+    testRatchetsCompileToEvents();
+    testFullTable();
+    testRatchetPlayback();
+    testVoiceTransposesOneHit();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,466 @@
+#include "sequencer_test_helpers.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct PlayedStep
+{
+    int64_t sampleTime;
+    int step;
+    bool voice0;
+};
+
+// Runs the sequencer for numBlocks and returns every step it played, from the position reports
+static std::vector<PlayedStep> run(Sequencer& sequencer, int numBlocks, int blockSize, int64_t& clock,
+                                   std::vector<int64_t>* hits = nullptr)
+{
+    std::vector<int64_t> voice0Hits;
+    for (const auto& hit : hitsOn(render(sequencer, numBlocks * blockSize, blockSize, clock), 0))
+        voice0Hits.push_back(hit.sampleTime);
+
+    std::vector<PlayedStep> played;
+    Sequencer::Position position;
+    while (sequencer.popPosition(position))
+    {
+        if (position.playing)
+            played.push_back({position.sampleTime, position.step,
+                              std::find(voice0Hits.begin(), voice0Hits.end(), position.sampleTime) != voice0Hits.end()});
+    }
+    if (hits != nullptr)
+        *hits = voice0Hits;
+    return played;
+}
+
+static Sequencer::Pattern everyStepOnVoice0()
+{
+    Sequencer::Pattern pattern;
+    for (int s = 0; s < Sequencer::NUM_STEPS; ++s)
+        pattern.setStep(0, s, true);
+    return pattern;
+}
+
+void testSampleAccurateSteps()
+{
+    // 120 BPM at 48k: a 16th is exactly 6000 samples, whatever the block size
+    for (int blockSize : {64, 441, 512, 4096})
+    {
+        auto sequencer = std::make_unique<Sequencer>();
+        sequencer->prepare(48000.0);
+        sequencer->setBPM(120.0);
+        sequencer->setPattern(everyStepOnVoice0());
+        sequencer->play();
+
+        int64_t clock = 0;
+        std::vector<int64_t> hits;
+        const auto played = run(*sequencer, 48000 * 2 / blockSize, blockSize, clock, &hits);
+        assert(played.size() >= 15 && hits.size() == played.size());
+        for (size_t i = 0; i < played.size(); ++i)
+        {
+            assert(played[i].sampleTime == static_cast<int64_t>(i) * 6000);
+            assert(played[i].step == static_cast<int>(i % Sequencer::NUM_STEPS));
+            assert(hits[i] == played[i].sampleTime);
+        }
+    }
+    std::cout << "Test: Steps land on exact samples for any block size - Passed" << std::endl;
+}
+
+void testSwing()
+{
+    // 58% swing: off-beat 16ths move 154 ticks (962.5 samples at 120 BPM) later, the grid does not
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    sequencer->setSwing(0.58f);
+    sequencer->setPattern(everyStepOnVoice0());
+    sequencer->play();
+
+    int64_t clock = 0;
+    std::vector<int64_t> hits;
+    const auto played = run(*sequencer, 192, 512, clock, &hits); // 17 steps, the last one even
+    assert(hits.size() == played.size() && hits.size() >= 16);
+    for (size_t i = 0; i < hits.size(); ++i)
+    {
+        assert(played[i].sampleTime == static_cast<int64_t>(i) * 6000);
+        assert(hits[i] == static_cast<int64_t>(i) * 6000 + ((i & 1) != 0 ? 963 : 0));
+    }
+    std::cout << "Test: Swing delays the off-beats only - Passed" << std::endl;
+}
+
+void testTempoChangeKeepsPosition()
+{
+    // Half way through step 0 at 120 BPM, double the tempo: the other half takes 1500 samples
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    sequencer->play();
+
+    int64_t clock = 0;
+    run(*sequencer, 1, 3000, clock);
+    sequencer->setBPM(240.0);
+    const auto played = run(*sequencer, 1, 6000, clock);
+    assert(played.size() == 2);
+    assert(played[0].sampleTime == 4500 && played[0].step == 1);
+    assert(played[1].sampleTime == 7500 && played[1].step == 2);
+
+    std::cout << "Test: Tempo change keeps the position - Passed" << std::endl;
+}
+
+void testManyTempoChangesBetweenBlocks()
+{
+    // A slider drag with the audio thread stalled: far more changes than the command
+    // queue holds, then play. The last tempo wins and the play is not lost
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    for (int i = 0; i < 500; ++i)
+        sequencer->setBPM(60.0 + i % 180);
+    sequencer->setBPM(240.0);
+    sequencer->play();
+    assert(sequencer->getBPM() == 240.0);
+
+    int64_t clock = 0;
+    const auto played = run(*sequencer, 1, 6000, clock);
+    assert(played.size() == 2);
+    assert(played[0].sampleTime == 0 && played[1].sampleTime == 3000);
+
+    std::cout << "Test: Many tempo changes between blocks - Passed" << std::endl;
+}
+
+void testPolymeter()
+{
+    // 16-step kick, 12-step hat, 3 x 8th perc and a 1-step 32nd roll over the 16-step bar
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    Sequencer::Pattern pattern;
+    for (int v = 0; v < 4; ++v)
+        pattern.setStep(v, 0, true);
+    pattern.setLength(1, 12);
+    pattern.setLength(2, 3);
+    pattern.setRate(2, Sequencer::Eighth);
+    pattern.setLength(3, 1);
+    pattern.setRate(3, Sequencer::ThirtySecond);
+    sequencer->setPattern(pattern);
+    sequencer->play();
+
+    const int64_t expectedPeriod[4] = {96000, 72000, 36000, 3000};
+    std::vector<int64_t> hits[4];
+    int64_t clock = 0;
+    auto runBlocks = [&](int numBlocks) {
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            sequencer->process(512, [&](int offset, const Sequencer::Trigger& hit) {
+                assert(hit.voice < 4);
+                hits[hit.voice].push_back(clock + offset);
+            });
+            clock += 512;
+        }
+        Sequencer::Position position;
+        while (sequencer->popPosition(position)) {}
+    };
+
+    runBlocks(300); // 153600 samples: 1.6 bars
+    for (int v = 0; v < 4; ++v)
+    {
+        assert(hits[v].size() == static_cast<size_t>(153600 / expectedPeriod[v] + 1));
+        for (size_t i = 0; i < hits[v].size(); ++i)
+            assert(hits[v][i] == static_cast<int64_t>(i) * expectedPeriod[v]);
+    }
+
+    // A pattern change restarts every track in phase on the next bar (192000)
+    sequencer->setPattern(pattern, Sequencer::Command::NextBar);
+    for (auto& h : hits)
+        h.clear();
+    runBlocks(100);
+    assert(hits[1].size() == 1 && hits[1][0] == 192000); // not 216000
+    assert(hits[2].size() == 2 && hits[2][0] == 180000 && hits[2][1] == 192000); // not 216000 either
+
+    std::cout << "Test: Tracks loop at their own length and rate - Passed" << std::endl;
+}
+
+void testPassedEditNotPlayedLate()
+{
+    // Half way through step 1, switching step 1 on must wait for the next bar, not fire now
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    sequencer->play();
+
+    int64_t clock = 0;
+    std::vector<int64_t> hits;
+    run(*sequencer, 1, 9000, clock, &hits);
+    sequencer->setStep(0, 1, true);
+    run(*sequencer, 16, 6000, clock, &hits);
+    assert(hits.size() == 1 && hits[0] == 102000);
+
+    std::cout << "Test: Edits behind the play position wait for the next loop - Passed" << std::endl;
+}
+
+void testBankAndSong()
+{
+    // Slot n plays voice n on step 0 only; the song is 0 x2, 5 x1, 2 x3 and loops
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    for (int slot : {0, 2, 5})
+    {
+        sequencer->setEditSlot(slot);
+        sequencer->setStep(slot, 0, true);
+    }
+    Sequencer::Song song;
+    song.add(0, 2);
+    song.add(5);
+    song.add(2, 3);
+    sequencer->setSong(song);
+    sequencer->followSong(0);
+    sequencer->play();
+
+    // One hit per bar (96000 samples), the voice tells which slot played it
+    std::vector<int> voices;
+    for (int b = 0; b < 8 * 96000 / 500; ++b)
+        sequencer->process(500, [&](int, const Sequencer::Trigger& hit) { voices.push_back(hit.voice); });
+    assert((voices == std::vector<int>{0, 0, 5, 2, 2, 2, 0, 0}));
+
+    Sequencer::Position position, last;
+    while (sequencer->popPosition(position))
+        last = position;
+    assert(last.slot == 0 && last.songEntry == 0);
+
+    // Selecting a slot leaves song mode on the next bar
+    sequencer->selectPattern(5);
+    voices.clear();
+    for (int b = 0; b < 3 * 96000 / 500; ++b)
+        sequencer->process(500, [&](int, const Sequencer::Trigger& hit) { voices.push_back(hit.voice); });
+    assert((voices == std::vector<int>{5, 5, 5}));
+    while (sequencer->popPosition(position))
+        last = position;
+    assert(last.slot == 5 && last.songEntry == -1);
+
+    // Without loop the transport stops after the last entry
+    song.loop = false;
+    sequencer->setSong(song);
+    sequencer->followSong(2);
+    voices.clear();
+    for (int b = 0; b < 6 * 96000 / 500; ++b)
+        sequencer->process(500, [&](int, const Sequencer::Trigger& hit) { voices.push_back(hit.voice); });
+    assert((voices == std::vector<int>{2, 2, 2}) && !sequencer->getPlaying());
+
+    std::cout << "Test: Bank slots and song on bar boundaries - Passed" << std::endl;
+}
+
+void testStateRoundTrip()
+{
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->setBPM(96.0);
+    sequencer->setSwing(0.6f);
+    sequencer->setHumanize(4.0f, 0.25f);
+    sequencer->setSeed(0xdeadbeef);
+
+    // Slot 5: a 64-step 32nd track with every kind of per-step data, step 63 included
+    sequencer->setEditSlot(5);
+    sequencer->setLength(0, 64);
+    sequencer->setRate(0, Sequencer::ThirtySecond);
+    sequencer->setStep(0, 63, true, true);
+    sequencer->setStep(0, 2, true);
+    sequencer->setLock(0, 2, Voice::Tune, -7.5f);
+    sequencer->setCondition(0, 2, Sequencer::Condition::ratio(3, 4));
+    sequencer->setProbability(0, 63, 35);
+    sequencer->setRatchet(0, 63, 6, -40, 12);
+    sequencer->setMicroTiming(0, 2, -0.125f);
+    sequencer->setEditSlot(9);
+    sequencer->setStep(1, 0, true);
+
+    Sequencer::Song song;
+    song.add(5, 4);
+    song.add(9, 2);
+    song.loop = false;
+    sequencer->setSong(song);
+
+    auto restored = std::make_unique<Sequencer>();
+    restored->setEditSlot(1);
+    restored->setStep(11, 1, true); // replaced: slot 1 is not in the state
+    restored->setState(sequencer->getState());
+
+    assert(restored->getBPM() == 96.0 && restored->getSwing() == 0.6f && restored->getEditSlot() == 9);
+    assert(restored->getSong().numEntries == 2 && !restored->getSong().loop);
+    assert(restored->getSong().entries[0].slot == 5 && restored->getSong().entries[0].repeats == 4);
+    assert(!restored->getPattern(1).getStep(11, 1) && restored->getPattern(9).getStep(1, 0));
+
+    const auto& pattern = restored->getPattern(5);
+    float value = 0.0f;
+    assert(pattern.getLength(0) == 64 && pattern.getRate(0) == Sequencer::ThirtySecond);
+    assert(pattern.getSteps(0) == ((std::uint64_t{1} << 63) | 4) && pattern.getAccent(0, 63));
+    assert(pattern.getLock(0, 2, Voice::Tune, value) && value == -7.5f && pattern.numLocks == 1);
+    assert(pattern.getCondition(0, 2).kind == Sequencer::Condition::Ratio && pattern.getCondition(0, 2).a == 3);
+    assert(pattern.getProbability(0, 63) == 35 && pattern.getMicroTiming(0, 2) == -0.125f);
+    const auto ratchet = pattern.getRatchet(0, 63);
+    assert(ratchet.count == 6 && ratchet.velocityRamp == -40 && ratchet.pitchRamp == 12);
+
+    // What plays is the restored bank: same hits, same dice
+    std::vector<int64_t> original, copy;
+    int64_t clock = 0;
+    for (auto* s : {sequencer.get(), restored.get()})
+    {
+        s->prepare(48000.0);
+        s->selectPattern(5);
+        s->play();
+        clock = 0;
+        run(*s, 2000, 512, clock, s == sequencer.get() ? &original : &copy); // four loops of the track
+    }
+    assert(!original.empty() && original == copy);
+
+    std::cout << "Test: Bank and song state round trip - Passed" << std::endl;
+}
+
+void testQuantisedCommands()
+{
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    sequencer->play();
+
+    int64_t clock = 0;
+    run(*sequencer, 1, 9000, clock); // steps 0 and 1 played, next boundary at 12000
+
+    // Locate applies on the next step boundary: step 8 plays at 12000
+    sequencer->locate(8);
+    auto played = run(*sequencer, 1, 6000, clock);
+    assert(played.size() == 1 && played[0].sampleTime == 12000 && played[0].step == 8);
+
+    // Stop at the bar: steps 9..15 still play, step 0 does not
+    sequencer->stop(Sequencer::Command::NextBar);
+    played = run(*sequencer, 20, 6000, clock);
+    assert(played.size() == 7 && played.back().step == 15);
+    assert(!sequencer->getPlaying());
+
+    std::cout << "Test: Locate on next step, stop on next bar - Passed" << std::endl;
+}
+
+void testPatternChangeOnBar()
+{
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+
+    Sequencer::Pattern first, second = everyStepOnVoice0();
+    sequencer->setPattern(first);
+    sequencer->play();
+
+    int64_t clock = 0;
+    run(*sequencer, 5, 6000, clock); // steps 0-4
+
+    // Queued for the bar: the rest of this bar keeps the old pattern, edits included
+    sequencer->setPattern(second, Sequencer::Command::NextBar);
+    const auto played = run(*sequencer, 12, 6000, clock); // steps 5-15, then 0
+    for (size_t i = 0; i + 1 < played.size(); ++i)
+        assert(!played[i].voice0);
+    assert(played.back().step == 0 && played.back().voice0);
+
+    std::cout << "Test: Pattern change waits for the bar - Passed" << std::endl;
+}
+
+void testPatternChangeWithBlockBetween()
+{
+    // setPattern(NextBar) sends the change before publishing; an audio block between
+    // the two must not take the new pattern mid-bar
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    sequencer->setPattern(Sequencer::Pattern{});
+    sequencer->play();
+
+    int64_t clock = 0;
+    run(*sequencer, 5, 6000, clock); // steps 0-4
+
+    sequencer->selectPattern(sequencer->getEditSlot(), Sequencer::Command::NextBar);
+    auto played = run(*sequencer, 1, 6000, clock); // step 5, with the change queued
+    sequencer->setPattern(everyStepOnVoice0());    // the publish, a block late
+    const auto rest = run(*sequencer, 11, 6000, clock); // steps 6-15, then 0
+    played.insert(played.end(), rest.begin(), rest.end());
+    for (size_t i = 0; i + 1 < played.size(); ++i)
+        assert(!played[i].voice0);
+    assert(played.back().step == 0 && played.back().voice0);
+
+    std::cout << "Test: Pattern change with a block before the publish - Passed" << std::endl;
+}
+
+void testNoTornPatterns()
+{
+    // The editor keeps rewriting the whole pattern (one bit per step, same on every voice)
+    // and poking the transport; the audio side must only ever see complete patterns
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(300.0); // 2400 samples per step
+    sequencer->play();
+    std::atomic<bool> done { false };
+
+    std::thread editor([&] {
+        for (int generation = 0; generation < 20000; ++generation)
+        {
+            Sequencer::Pattern pattern;
+            for (int v = 0; v < Sequencer::NUM_VOICES; ++v)
+                for (int s = 0; s < Sequencer::NUM_STEPS; ++s)
+                    pattern.setStep(v, s, ((generation >> (s % 4)) & 1) != 0, (generation & 1) != 0);
+            sequencer->setPattern(pattern);
+            if ((generation & 255) == 0)
+            {
+                sequencer->setBPM(200.0 + generation % 100);
+                sequencer->locate(generation % Sequencer::NUM_STEPS);
+                std::this_thread::yield();
+            }
+        }
+        done = true;
+    });
+
+    // Hits sharing a sample come from one step: all 12 voices or none, one velocity
+    int steps = 0, blocks = 0;
+    Sequencer::Position position;
+    while (!done.load() || blocks < 1000)
+    {
+        ++blocks;
+        int groupOffset = -1, groupSize = 0;
+        float groupVelocity = 0.0f;
+        sequencer->process(2400, [&](int offset, const Sequencer::Trigger& hit) {
+            if (offset != groupOffset)
+            {
+                assert(groupSize == 0 || groupSize == Sequencer::NUM_VOICES);
+                groupOffset = offset;
+                groupSize = 0;
+                groupVelocity = hit.velocity;
+                ++steps;
+            }
+            assert(hit.voice == groupSize && hit.velocity == groupVelocity);
+            ++groupSize;
+        });
+        assert(groupSize == 0 || groupSize == Sequencer::NUM_VOICES);
+        while (sequencer->popPosition(position)) {}
+        std::this_thread::yield();
+    }
+    editor.join();
+
+    std::cout << "Test: No torn patterns - " << steps << " steps checked" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== Sequencer Transport & Pattern Handoff Tests ===" << std::endl;
+
+    testSampleAccurateSteps();
+    testSwing();
+    testTempoChangeKeepsPosition();
+    testManyTempoChangesBetweenBlocks();
+    testPolymeter();
+    testPassedEditNotPlayedLate();
+    testBankAndSong();
+    testStateRoundTrip();
+    testQuantisedCommands();
+    testPatternChangeOnBar();
+    testPatternChangeWithBlockBetween();
+    testNoTornPatterns();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "../../../Source/SpscQueue.h"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+void testFillAndDrain()
+{
+    SpscQueue<int, 8> queue;
+    int value = 0;
+    assert(!queue.pop(value));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        const bool pushed = queue.push(i);
+        assert(pushed);
+    }
+    assert(!queue.push(99)); // full: rejected, nothing overwritten
+    assert(queue.size() == 8);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        const bool popped = queue.pop(value);
+        assert(popped && value == i);
+    }
+    assert(!queue.pop(value));
+
+    std::cout << "Test: Fill and drain - Passed" << std::endl;
+}
+
+void testConcurrentOrder()
+{
+    // One producer, one consumer, a small queue so both sides keep hitting full / empty
+    constexpr uint32_t count = 200000;
+    SpscQueue<uint32_t, 64> queue;
+
+    std::thread producer([&queue] {
+        for (uint32_t i = 0; i < count;)
+            if (queue.push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+    });
+
+    uint32_t expected = 0, value = 0;
+    while (expected < count)
+    {
+        if (queue.pop(value))
+        {
+            assert(value == expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    std::cout << "Test: Concurrent order - " << count << " items in order" << std::endl;
+    assert(queue.size() == 0);
+}
+
+int main()
+{
+    std::cout << "=== SPSC Queue Unit Tests ===" << std::endl;
+
+    testFillAndDrain();
+    testConcurrentOrder();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
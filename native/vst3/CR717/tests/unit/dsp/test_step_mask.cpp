@@ -0,0 +1,135 @@
+#include "../../../Source/Sequencer.h"
+#include "../../../Source/PatternRandomizer.h"
+#include <cassert>
+#include <iostream>
+
+static std::uint64_t fromString(const char* steps)
+{
+    std::uint64_t bits = 0;
+    for (int i = 0; steps[i] != 0; ++i)
+        if (steps[i] == 'x')
+            bits |= std::uint64_t{1} << i;
+    return bits;
+}
+
+void testEuclidean()
+{
+    assert(StepMask::euclidean(3, 8) == fromString("x..x..x."));
+    assert(StepMask::euclidean(4, 16) == fromString("x...x...x...x..."));
+    assert(StepMask::euclidean(5, 16, 2) == StepMask::rotate(StepMask::euclidean(5, 16), 2, 16));
+    assert(StepMask::euclidean(0, 16) == 0);
+    assert(StepMask::euclidean(64, 64) == ~std::uint64_t{0});
+    for (int length = 1; length <= 64; ++length)
+        for (int hits = 0; hits <= length; ++hits)
+            assert(StepMask::count(StepMask::euclidean(hits, length)) == hits);
+
+    std::cout << "Test: Euclidean fill - Passed" << std::endl;
+}
+
+void testRotateInvert()
+{
+    const auto bits = fromString("xx......x...");
+    assert(StepMask::rotate(bits, 1, 12) == fromString(".xx......x.."));
+    assert(StepMask::rotate(bits, -1, 12) == fromString("x......x...x"));
+    assert(StepMask::rotate(bits, 12, 12) == bits);
+    assert(StepMask::rotate(bits, 25, 12) == StepMask::rotate(bits, 1, 12));
+    assert(StepMask::rotate(~std::uint64_t{0}, 5, 64) == ~std::uint64_t{0});
+    assert(StepMask::invert(bits, 12) == fromString("..xxxxxx.xxx"));
+    assert(StepMask::invert(0, 64) == ~std::uint64_t{0});
+
+    std::cout << "Test: Rotate and invert wrap at the track length - Passed" << std::endl;
+}
+
+void testPatternApi()
+{
+    Sequencer::Pattern pattern;
+    pattern.setStep(0, 0, true, true);
+    pattern.setStep(0, 63, true);
+    pattern.setStep(0, 64, true); // out of range, ignored
+    pattern.setAccent(0, 5, true); // not on, ignored
+    assert(pattern.getStep(0, 0) && pattern.getAccent(0, 0));
+    assert(pattern.getStep(0, 63) && !pattern.getStep(0, 64));
+    assert(!pattern.getAccent(0, 5) && pattern.density(0) == 2);
+
+    // Accents follow their steps through word operations
+    pattern.clear();
+    pattern.setSteps(1, fromString("x...x..."), fromString("x...x..."));
+    pattern.rotate(1, 2, 8);
+    assert(pattern.getSteps(1) == fromString("..x...x.") && pattern.getAccents(1) == pattern.getSteps(1));
+    pattern.invert(1, 8);
+    assert(pattern.getSteps(1) == fromString("xx.xxx.x") && pattern.getAccents(1) == 0);
+    pattern.merge(2, fromString("x.x."), fromString("xx.."));
+    assert(pattern.getSteps(2) == fromString("x.x.") && pattern.getAccents(2) == fromString("x..."));
+    pattern.setStep(2, 0, false);
+    assert(pattern.getAccents(2) == 0);
+
+    // Array conversions for presets and the randomizer
+    const std::array<bool, 16> steps = {true, false, false, true};
+    assert(StepMask::fromArray(steps) == fromString("x..x"));
+    assert(StepMask::toArray<16>(fromString("x..x")) == steps);
+
+    std::cout << "Test: Pattern API over step masks - Passed" << std::endl;
+}
+
+void testTimelineFromMasks()
+{
+    // Each voice compiles to its own track: hits up to the track length, accents as velocity
+    Sequencer::Pattern pattern;
+    pattern.euclidean(3, 4);
+    pattern.setSteps(0, fromString("x...x...x"), fromString("x"));
+    pattern.setLength(0, 6);
+    pattern.setRate(0, Sequencer::Eighth);
+    Sequencer::Timeline timeline;
+    Sequencer::Timeline::compile(pattern, 0.0f, timeline);
+
+    const auto& kick = timeline.tracks[0];
+    assert(kick.numEvents == 2 && kick.lengthTicks == 6 * 1920);
+    assert(timeline.event(0, 0).tick == 0 && timeline.event(0, 0).velocity == 1.0f);
+    assert(timeline.event(0, 1).tick == 4 * 1920 && timeline.event(0, 1).velocity == 0.8f);
+
+    const auto& tom = timeline.tracks[3];
+    assert(tom.numEvents == 4 && tom.lengthTicks == 16 * Sequencer::TICKS_PER_STEP);
+    assert(timeline.seek(3, 1) == 1 && timeline.seek(3, 12 * Sequencer::TICKS_PER_STEP) == 3 && timeline.event(3, 3).voice == 3);
+    assert(timeline.tracks[1].numEvents == 0);
+
+    std::cout << "Test: Timeline compiled from masks - Passed" << std::endl;
+}
+
+void testRandomizedSteps()
+{
+    // The randomizer's masks keep to the genre's allowed steps and match its arrays
+    PatternRandomizer randomizer;
+    for (uint32_t seed = 0; seed < 50; ++seed)
+    {
+        randomizer.setSeed(seed);
+        const auto kick = randomizer.generateSteps("BD", "House", 1.0f);
+        assert((kick & ~fromString("x...x...x...x...")) == 0);
+        randomizer.setSeed(seed);
+        assert(StepMask::fromArray(randomizer.generatePattern("BD", "House", 1.0f)) == kick);
+    }
+
+    // Randomizing a voice redraws its steps, the track settings stay
+    Sequencer::Pattern pattern;
+    pattern.setLength(7, 12);
+    pattern.setRate(7, Sequencer::Eighth);
+    randomizer.setSeed(7);
+    const auto hats = randomizer.generateSteps("CH", "Techno", 1.0f);
+    pattern.setSteps(7, hats);
+    assert(pattern.getSteps(7) == hats && pattern.getLength(7) == 12 && pattern.getRate(7) == Sequencer::Eighth);
+
+    std::cout << "Test: Randomized steps - Passed" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== Step Mask Unit Tests ===" << std::endl;
+
+    testEuclidean();
+    testRotateInvert();
+    testPatternApi();
+    testTimelineFromMasks();
+    testRandomizedSteps();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
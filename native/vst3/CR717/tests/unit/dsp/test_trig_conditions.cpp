@@ -0,0 +1,189 @@
+#include "sequencer_test_helpers.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// 120 BPM at 48k: a 16th is 6000 samples, a bar 96000
+static constexpr int STEP = 6000;
+static constexpr int BAR = 16 * STEP;
+
+static int countVoice(const std::vector<Hit>& hits, int voice)
+{
+    return static_cast<int>(std::count_if(hits.begin(), hits.end(), [voice](const Hit& h) { return h.voice == voice; }));
+}
+
+static bool playsInBar(const std::vector<Hit>& hits, int voice, int bar)
+{
+    return std::any_of(hits.begin(), hits.end(),
+                       [=](const Hit& h) { return h.voice == voice && h.sampleTime == int64_t{bar} * BAR; });
+}
+
+void testConditions()
+{
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    for (int voice = 0; voice < 5; ++voice)
+        sequencer->setStep(voice, 0, true);
+    sequencer->setCondition(0, 0, Sequencer::Condition::ratio(1, 2));
+    sequencer->setCondition(1, 0, Sequencer::Condition::ratio(3, 4));
+    sequencer->setCondition(2, 0, {Sequencer::Condition::First});
+    sequencer->setCondition(3, 0, {Sequencer::Condition::Fill});
+    sequencer->setCondition(4, 0, {Sequencer::Condition::NotFill});
+    assert(sequencer->getCondition(1, 0).a == 3 && sequencer->getCondition(1, 0).b == 4);
+
+    int64_t clock = 0;
+    sequencer->play(0);
+    const auto hits = render(*sequencer, 8 * BAR, 512, clock);
+    for (int bar = 0; bar < 8; ++bar)
+    {
+        assert(playsInBar(hits, 0, bar) == (bar % 2 == 0));
+        assert(playsInBar(hits, 1, bar) == (bar % 4 == 2));
+        assert(playsInBar(hits, 2, bar) == (bar == 0));
+        assert(!playsInBar(hits, 3, bar));
+        assert(playsInBar(hits, 4, bar));
+    }
+
+    // Fill flips Fill / NotFill from the next hit on
+    sequencer->setFill(true);
+    const auto filled = render(*sequencer, 2 * BAR, 512, clock);
+    assert(countVoice(filled, 3) == 2 && countVoice(filled, 4) == 0);
+
+    // Counting starts over from play: First plays again
+    sequencer->setFill(false);
+    sequencer->play(0);
+    const auto again = render(*sequencer, 2 * BAR, 512, clock);
+    assert(countVoice(again, 2) == 1 && countVoice(again, 0) == 1);
+
+    // A cleared step loses its condition
+    sequencer->setStep(2, 0, false);
+    assert(sequencer->getCondition(2, 0).kind == Sequencer::Condition::Always);
+
+    std::cout << "Test: Trig conditions (1:2, 3:4, first, fill, not fill) - Passed" << std::endl;
+}
+
+static std::vector<Hit> renderSeeded(std::uint32_t seed, int blockSize, float timingMs, float velocityAmount,
+                                     float amount = 1.0f)
+{
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    for (int step = 0; step < Sequencer::NUM_STEPS; ++step)
+    {
+        sequencer->setStep(0, step, true, step % 4 == 0);
+        sequencer->setStep(7, step, true);
+        sequencer->setProbability(7, step, 50);
+    }
+    sequencer->setHumanize(timingMs, velocityAmount);
+    sequencer->setHumanizeAmount(amount);
+    sequencer->setSeed(seed);
+
+    int64_t clock = 0;
+    sequencer->play(0);
+    return render(*sequencer, 32 * BAR, blockSize, clock);
+}
+
+void testProbabilityIsReproducible()
+{
+    const auto hits = renderSeeded(1234, 512, 0.0f, 0.0f);
+    const int played = countVoice(hits, 7);
+    std::cout << "Test: 50% probability - " << played << " of 512 steps" << std::endl;
+    assert(played > 256 - 48 && played < 256 + 48);
+    assert(countVoice(hits, 0) == 512); // 100 % is every time
+
+    // Same seed, same hits, whatever the block size; another seed rolls differently
+    assert(renderSeeded(1234, 37, 0.0f, 0.0f) == hits);
+    assert(renderSeeded(1234, 4096, 0.0f, 0.0f) == hits);
+    assert(!(renderSeeded(99, 512, 0.0f, 0.0f) == hits));
+    std::cout << "Test: Seeded probability reproducible - Passed" << std::endl;
+}
+
+void testHumanize()
+{
+    const float timingMs = 5.0f, velocityAmount = 0.2f;
+    const auto hits = renderSeeded(7, 512, timingMs, velocityAmount);
+    const int64_t spread = 240; // 5 ms at 48k
+
+    int offGrid = 0;
+    for (size_t i = 0; i < hits.size(); ++i)
+    {
+        const auto& hit = hits[i];
+        if (i > 0)
+            assert(hit.sampleTime >= hits[i - 1].sampleTime); // still in time order
+
+        // Within the spread, never before its own step (every hit here sits on one)
+        const int64_t grid = hit.sampleTime - hit.sampleTime % STEP;
+        assert(hit.sampleTime - grid <= spread);
+        offGrid += hit.sampleTime != grid ? 1 : 0;
+
+        if (hit.voice == 0)
+        {
+            const bool accented = (grid / STEP) % 4 == 0;
+            const float base = accented ? 1.0f : 0.8f;
+            assert(hit.velocity >= base * (1.0f - velocityAmount) - 1.0e-6f);
+            assert(hit.velocity <= std::min(1.0f, base * (1.0f + velocityAmount)) + 1.0e-6f);
+        }
+    }
+    std::cout << "Test: Humanise - " << offGrid << " of " << hits.size() << " hits off the grid" << std::endl;
+    assert(offGrid > static_cast<int>(hits.size()) / 3); // the early half is held on the step
+
+    // Sample-exact and reproducible across block sizes
+    assert(renderSeeded(7, 1, timingMs, velocityAmount) == hits);
+    assert(renderSeeded(7, 441, timingMs, velocityAmount) == hits);
+    std::cout << "Test: Humanise reproducible per sample - Passed" << std::endl;
+}
+
+void testHumanizeAmount()
+{
+    // The amount scales the genre's spreads: none puts every hit back on the grid
+    const auto grid = renderSeeded(7, 512, 0.0f, 0.0f);
+    assert(renderSeeded(7, 512, 8.0f, 0.25f, 0.0f) == grid);
+    assert(renderSeeded(7, 512, 5.0f, 0.2f, 0.5f) == renderSeeded(7, 512, 2.5f, 0.1f));
+    assert(!(renderSeeded(7, 512, 5.0f, 0.2f, 0.5f) == grid));
+    std::cout << "Test: Humanise amount - Passed" << std::endl;
+}
+
+void testOffGridHitsMoveBothWays()
+{
+    // Swung hits sit inside their step, so humanisation can pull them early as well
+    auto sequencer = std::make_unique<Sequencer>();
+    sequencer->prepare(48000.0);
+    sequencer->setBPM(120.0);
+    sequencer->setRate(0, Sequencer::ThirtySecond);
+    sequencer->setLength(0, 32);
+    for (int step = 1; step < 32; step += 2)
+        sequencer->setStep(0, step, true); // the "and" of every 16th, 3000 samples in
+    sequencer->setHumanize(10.0f, 0.0f);
+
+    int64_t clock = 0;
+    sequencer->play(0);
+    const auto hits = render(*sequencer, 16 * BAR, 512, clock);
+    int early = 0, late = 0;
+    for (const auto& hit : hits)
+    {
+        const int64_t grid = hit.sampleTime - hit.sampleTime % STEP + STEP / 2;
+        assert(std::abs(hit.sampleTime - grid) <= 480);
+        early += hit.sampleTime < grid ? 1 : 0;
+        late += hit.sampleTime > grid ? 1 : 0;
+    }
+    std::cout << "Test: Off-grid humanise - " << early << " early, " << late << " late" << std::endl;
+    assert(hits.size() == 256 && early > 64 && late > 64);
+}
+
+int main()
+{
+    std::cout << "=== Trig Condition & Humanise Tests ===" << std::endl;
+
+    testConditions();
+    testProbabilityIsReproducible();
+    testHumanize();
+    testHumanizeAmount();
+    testOffGridHitsMoveBothWays();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}